@@ -0,0 +1,279 @@
+/**
+@file  Gen05.cpp
+@author  Christopher Eichstedt
+@version  1.0
+@brief  Generates large, reproducible meta-data files for the simulator from a seed.
+**/
+
+//----------------------------------------------------------------------------------------------------
+//libraries, declarations & global variables
+//----------------------------------------------------------------------------------------------------
+
+//-------------------------
+//included libraries
+//-------------------------
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <stdexcept>
+#include <cstdlib>
+#include <cmath>
+#include <random>
+using namespace std;
+
+//-------------------------
+//struct declarations
+//-------------------------
+struct genConfig
+{
+	string outputFile; //meta-data file to write
+	long processes; //number of applications
+	long opsPerProcess; //operations between A{begin} and A{finish}
+	int ioPercent; //chance an operation is input/output
+	int meanBurst; //mean cycles per operation
+	char distribution; //'U' uniform or 'E' exponential bursts
+	unsigned long seed;
+};
+
+struct genOp
+{
+	const char* text; //code and descriptor, as readInput() matches them
+	int weight; //relative chance within its group
+};
+
+//-------------------------
+//global variables
+//-------------------------
+
+//same operations readInput() understands, split into processor and input/output groups
+const int NUMcpuOps = 3;
+const genOp cpuOps[NUMcpuOps] =
+{
+	{"P{run}", 70},
+	{"M{block}", 20},
+	{"M{allocate}", 10}
+};
+const int NUMioOps = 6;
+const genOp ioOps[NUMioOps] =
+{
+	{"O{monitor}", 1},
+	{"O{projector}", 1},
+	{"O{hard drive}", 1},
+	{"I{keyboard}", 1},
+	{"I{hard drive}", 1},
+	{"I{scanner}", 1}
+};
+const int OPSperLine = 5;
+
+genConfig tempGen;
+mt19937 generator; //engine output is fixed by the standard, the draws below are done by hand so every platform gets the same file
+
+//-------------------------
+//function declarations
+//-------------------------
+void readArgs(int, char**) throw(runtime_error);
+void writeWorkload() throw(runtime_error);
+const char* pickOp(const genOp*, int);
+int drawBurst();
+double drawUniform();
+
+//----------------------------------------------------------------------------------------------------
+//main driver
+//----------------------------------------------------------------------------------------------------
+
+/**
+@brief  main function, reads the generator settings and writes the meta-data file
+@param  command line arguments: file processes ops io% meanBurst seed [U|E]
+@return  returns 0 to end program
+@pre  readArgs(), writeWorkload()
+@post  the meta-data file holds the generated workload
+**/
+int main(int argc, char* argv[])
+{
+	readArgs(argc, argv);
+	writeWorkload();
+	return 0;
+}
+
+//----------------------------------------------------------------------------------------------------
+//functions
+//----------------------------------------------------------------------------------------------------
+
+/**
+@brief  a function that reads the generator settings from the command line into a global struct
+@param  int argc, char *argv[]
+@return  none
+@pre  none
+@post  stores the settings into tempGen and seeds the generator
+**/
+void readArgs(int argc, char* argv[]) throw(runtime_error)
+{
+	if(argc < 7)
+	{
+		throw runtime_error("usage: Gen05 file processes ops io% meanBurst seed [U|E]");
+	}
+	
+	tempGen.outputFile = argv[1];
+	tempGen.processes = atol(argv[2]);
+	tempGen.opsPerProcess = atol(argv[3]);
+	tempGen.ioPercent = atoi(argv[4]);
+	tempGen.meanBurst = atoi(argv[5]);
+	tempGen.seed = strtoul(argv[6], NULL, 10);
+	tempGen.distribution = 'U';
+	
+	if(argc > 7)
+	{
+		tempGen.distribution = argv[7][0];
+	}
+	
+	if(tempGen.processes < 1 || tempGen.opsPerProcess < 1)
+	{
+		throw runtime_error("processes and ops must be at least 1");
+	}
+	
+	if(tempGen.ioPercent < 0 || tempGen.ioPercent > 100)
+	{
+		throw runtime_error("io% must be between 0 and 100");
+	}
+	
+	if(tempGen.meanBurst < 1)
+	{
+		throw runtime_error("meanBurst must be at least 1");
+	}
+	
+	if(tempGen.distribution != 'U' && tempGen.distribution != 'E')
+	{
+		throw runtime_error("burst distribution must be U or E");
+	}
+	
+	generator.seed(tempGen.seed);
+}
+
+/**
+@brief  a function that streams the workload to the meta-data file, in the same layout as the shipped test files
+@param  none
+@return  none
+@pre  readArgs()
+@post  writes S{begin}, every application and S{finish}
+**/
+void writeWorkload() throw(runtime_error)
+{
+	ofstream outFile(tempGen.outputFile.c_str());
+	
+	if(!outFile.is_open())
+	{
+		throw runtime_error("meta-data file could not be opened");
+	}
+	
+	stringstream line;
+	int count = 1;
+	outFile << "Start Program Meta-Data Code:\n";
+	line << "S{begin}0";
+	
+	for(long i = 0; i < tempGen.processes; i++)
+	{
+		for(long j = -1; j <= tempGen.opsPerProcess; j++)
+		{
+			//separator, OPSperLine operations to a line
+			if(count == OPSperLine)
+			{
+				line << ";\n";
+				outFile << line.str();
+				line.str("");
+				count = 0;
+			}
+			
+			else
+			{
+				line << "; ";
+			}
+			
+			count++;
+			
+			if(j < 0)
+			{
+				line << "A{begin}0";
+			}
+			
+			else if(j == tempGen.opsPerProcess)
+			{
+				line << "A{finish}0";
+			}
+			
+			else if(drawUniform()*100.0 < tempGen.ioPercent)
+			{
+				line << pickOp(ioOps, NUMioOps) << drawBurst();
+			}
+			
+			else
+			{
+				line << pickOp(cpuOps, NUMcpuOps) << drawBurst();
+			}
+		}
+	}
+	
+	line << "; S{finish}0.\n";
+	outFile << line.str() << "End Program Meta-Data Code.\n";
+	outFile.close();
+}
+
+/**
+@brief  picks one operation from a group by weight
+@param  const genOp *ops, int count
+@return  const char* the operation text
+@pre  readArgs()
+@post  advances the generator
+**/
+const char* pickOp(const genOp* ops, int count)
+{
+	int total = 0;
+	
+	for(int i = 0; i < count; i++)
+	{
+		total += ops[i].weight;
+	}
+	
+	int pick = (int)(drawUniform()*total);
+	
+	for(int i = 0; i < count; i++)
+	{
+		pick -= ops[i].weight;
+		
+		if(pick < 0)
+		{
+			return ops[i].text;
+		}
+	}
+	
+	return ops[count - 1].text;
+}
+
+/**
+@brief  draws the cycles for one operation, uniform on 1..2*mean-1 or exponential with about the given mean
+@param  none
+@return  int cycles, at least 1
+@pre  readArgs()
+@post  advances the generator
+**/
+int drawBurst()
+{
+	if(tempGen.distribution == 'E')
+	{
+		return 1 + (int)(-(tempGen.meanBurst - 1)*log(1.0 - drawUniform()));
+	}
+	
+	return 1 + (int)(drawUniform()*(2*tempGen.meanBurst - 1));
+}
+
+/**
+@brief  draws a number in [0, 1) from the raw engine output
+@param  none
+@return  double
+@pre  readArgs()
+@post  advances the generator
+**/
+double drawUniform()
+{
+	return generator()/4294967296.0;
+}
@@ -16,10 +16,30 @@
 #include <iomanip>
 #include <fstream>
 #include <queue>
+#include <deque>
+#include <vector>
+#include <map>
+#include <set>
 #include <string>
 #include <sstream>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+#include <cerrno>
 #include <time.h>
+#include <sched.h>
 #include <pthread.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
 using namespace std;
 
 //-------------------------
@@ -36,27 +56,94 @@ struct configData
 	int pjct; //projector cycle time
 	int numProj; //number of projectors
 	int numHDD; //number of hard drives
-	int countProjOut; //count projector output calls
-	int countHDDOut; //count hard drive output calls
-	int countHDDIn;	//count hard drive input calls
+	int numCores; //number of processors
 	int pqn; //processor quantum number
 	string logFile; //log file for output
+	string traceFile; //chrome trace output, none if empty
+	string metricsFile; //per process metrics csv, none if empty
 	string inputFile; //input file for meta data
 };
 
+struct configKey
+{
+	const char* key; //lower case with single spaces, unit left off
+	int type;
+	int* number; //CONFIGnumber, CONFIGmemory and CONFIGchoice
+	string* text; //CONFIGtext
+	const char* choices; //separated by |, a choice key's number is set to the index of the one given
+	int minimum; //CONFIGnumber and CONFIGmemory
+};
+
 struct inputData
 {
-	string opCode;
-	string opCommand;
+	int op; //index into opTable
+	int cycles; //number from the meta-data, the page touched by M{block}
 	int cycleTime;
 };
 
-struct processData
+struct opDescriptor
 {
-	queue<inputData> commands;
+	char code; //meta-data letter
+	const char* descriptor; //meta-data text between the brackets
+	int configData::*cycleTime; //cycle time field, NULL takes 1 msec
+	int device; //device class, -1 runs on the processor
+	const char* startText;
+	const char* endText;
+	const char* unitName; //printed with the device number, empty if there is only one
+};
+
+struct programData
+{
+	vector<inputData> commands; //never changes once parsed, shared by every copy of the application
+	vector<int> timeLeft; //msec from each command to the end of the program
 	int countIO;
 	int countTask;
+};
+
+struct compiledHeader
+{
+	char magic[8]; //COMPILEDmagic, changes whenever the layout does
+	unsigned long long hash; //of the source meta-data
+	unsigned long long size; //source bytes
+	unsigned int programs; //followed by programs + 1 command offsets, then the packed commands
+	unsigned int commands;
+};
+
+struct processData
+{
+	int id; //index into processTable
+	const programData* program;
+	int pc; //next command to run
+	int remaining; //msec left on that command, less than its cycle time after an interrupt
 	int processCount;
+	int next; //next process on the RR run queue, -1 at the tail
+	int core; //processor whose queue it is on or it last ran on
+	vector<int> memory; //addresses of the blocks it holds until A{finish}
+	map<int, int> pages; //page table, resident pages to frames
+	int state; //last state it was moved to, -1 before it is readied
+	double arrival; //simulation seconds, -1 until readied
+	double firstRun; //-1 until first dispatched
+	double finish; //-1 until it exits
+	double readySince; //-1 unless waiting on a ready queue
+	double waiting; //total time spent on ready queues
+	bool traced; //its trace track has been named
+};
+
+struct ioJob;
+
+struct coreData
+{
+	int running; //process id, -1 if idle
+	int quantum; //msec left in the running process's quantum
+	int rrHead; //RR run queue, linked through processData::next
+	int rrTail;
+	int rrSize;
+	vector<int> strHeap; //ready processes by shortest time remaining
+	double busyTime; //seconds spent running commands
+	long commands;
+	long steals; //processes taken from other processors' queues
+	double switchStart; //wall time of the last interrupt, -1 if none
+	ioJob* job; //processor command in flight, NULL if none
 };
 
 struct PCB
@@ -64,11 +151,115 @@ struct PCB
 	int processState;
 };
 
+struct frameData
+{
+	int address; //block it holds in system memory, -1 if the slot is empty
+	int process; //-1 if the frame is free
+	int page;
+	long loaded; //access stamp when it was paged in, for FIFO
+	long used; //access stamp of its last use, for LRU
+	bool referenced; //second chance bit, for clock
+};
+
+struct tlbEntry
+{
+	int process;
+	int page;
+	int frame;
+	long used;
+};
+
+struct benchResult
+{
+	const char* name;
+	long ops;
+	double seconds;
+	double opsPerSec;
+	double nsPerOp;
+	long peakRSS; //kbytes
+};
+
+struct runSummary
+{
+	int status; //0 finished, 1 threw, 2 crashed, -1 never reported
+	long processes; //finished processes
+	double clockEnd; //simulation seconds
+	double turnaround; //means over the finished processes, seconds
+	double waiting;
+	double response;
+	long switches; //quanta that ran out
+	double seconds; //wall time for the whole run
+	char error[128];
+};
+
 struct systemMemory
 {
 	int total;
 	int blockSize;
-	int count;
+};
+
+struct ioJob
+{
+	int process; //waits here until the interrupt
+	int processCount; //process number for the log, so workers need not read processTable
+	int op;
+	int device; //device class
+	int unit; //which hard drive or projector
+	int duration; //milliseconds
+	bool interrupted; //processor job cut short by the quantum or a preemption
+	int preemptedBy; //process that took the processor mid command, -1 if none
+	atomic<bool> cut; //tells the worker to stop at its next millisecond, real clocks only
+	long event; //sequence of its completion event, virtual clock only
+	int cylinder; //hard drive jobs only
+	double queued; //simulation time it was submitted
+	double startTime;
+	double endTime;
+	double submitted; //wall time the job was queued
+	double dispatchLatency; //wall time until a free worker picked it up
+};
+
+struct deviceQueue
+{
+	int device; //device class
+	deque<ioJob*> jobs; //taken in arrival order
+	multimap<int, ioJob*> cylinders; //hard drive jobs by cylinder, unless the disk policy is FCFS
+	bool busy; //virtual clock only
+	double lastDone; //wall time the worker finished its last job
+	int head; //cylinder the hard drive arm is on
+	int direction; //1 sweeping up, -1 sweeping down
+	long served;
+	long seekTotal; //cylinders moved
+	double waitTotal; //simulation seconds jobs spent queued
+	double busyTime; //simulation seconds spent running jobs
+	double available; //simulation time its assigned work runs out
+	pthread_mutex_t lock;
+	pthread_cond_t ready;
+	pthread_t worker;
+};
+
+struct logSlot
+{
+	atomic<unsigned long> sequence; //which lap of the ring the slot is on
+	int length;
+	char text[256];
+};
+
+struct traceRecord
+{
+	int type; //TRACEspan, TRACEready, TRACEexit or TRACEname
+	int op; //spans only
+	int track; //device*TRACEunits + unit for spans, the process id otherwise
+	int process; //process number
+	long start; //microseconds
+	long length;
+};
+
+struct simEvent
+{
+	double time; //simulated time the event fires at
+	long sequence; //tie breaker so equal times fire in schedule order
+	int type;
+	ioJob* job;
 };
 
 //-------------------------
@@ -79,6 +270,55 @@ struct systemMemory
 configData tempConfig;
 systemMemory tempMemory;
 
+//memory manager, sizes and addresses in the configured memory units
+const int MEMORYfirst = 0;
+const int MEMORYbest = 1;
+const int MEMORYbuddy = 2;
+int memoryPolicy = MEMORYfirst;
+map<int, int> memoryHoles; //free holes by address, so frees can join their neighbours
+set<pair<int, int> > memoryHoleSizes; //the same holes by size, for best fit
+vector<set<int> > buddyFree; //free buddy blocks by power of two
+map<int, int> memoryBlocks; //allocated blocks by address
+long memoryAllocs = 0;
+long memoryFailed = 0;
+double memoryLatency = 0.0; //wall time spent in memoryAllocate()
+double memoryFragTotal = 0.0; //external fragmentation sampled at every request
+int memoryInUse = 0;
+int memoryPeak = 0;
+long memoryInternal = 0; //lost to rounding blocks up
+
+//paging for M{block}, each frame a memory block taken from the same pool as M{allocate}
+const int PAGINGoff = 0;
+const int PAGINGfifo = 1;
+const int PAGINGlru = 2;
+const int PAGINGclock = 3;
+int pagingPolicy = PAGINGoff;
+int tlbSize = 16;
+int processPages = 8; //pages each process's M{block} commands touch
+vector<frameData> frames;
+int frameCount = 0; //frames holding a block of system memory
+int framePeak = 0;
+vector<tlbEntry> tlb; //fully associative, least recently used entry replaced
+int clockHand = 0;
+long pageStamp = 0;
+long pageAccesses = 0;
+long tlbHits = 0;
+long pageTableHits = 0; //TLB misses found in the page table
+long pageFaults = 0;
+long pageEvictions = 0;
+
+//batch runs and sweeps, read by the forked runs
+vector<string> batchConfigs;
+vector<pair<int, int> > sweepSettings; //quantum and processor cycle time, 0 keeps the config's
+const int SWEEPmaxRuns = 100000;
+
+//benchmarks
+const long BENCHmemoryOps = 1000000;
+const int BENCHholders = 64; //processes holding memory during the memory benchmarks
+const int BENCHholding = 4; //blocks each holder keeps before it gives them back
+const long BENCHlogOps = 1000000;
+const int BENCHstages = 5; //three memory policies, the logger and the scheduler, each in its own process
+
 //process control block
 PCB tempPCB;
 const int PCBexit = 0;
@@ -89,66 +329,367 @@ const int PCBwaiting = 4;
 
 //clock
 int timerStart = clock();
-double clockStart = (clock()-timerStart)/(double)(CLOCKS_PER_SEC);
-double startTime;
-double endTime;
+const int CLOCKspin = 0; //busy wait on clock() for every cycle
+const int CLOCKvirtual = 1; //discrete event simulation, no waiting
+const int CLOCKreal = 2; //wall clock time, cycles sleep until they are due
+int clockMode = CLOCKspin;
+chrono::steady_clock::time_point realStart = chrono::steady_clock::now();
+bool hostTimings = true; //report wall clock costs of the simulator itself
+
+//discrete event simulation
+const int EVENTdone = 0; //a processor or device finished its job
+double simClock = 0.0;
+long eventSequence = 0;
+set<long> cancelledEvents; //completion events of commands cut short, skipped when they come up
+priority_queue<simEvent, vector<simEvent>, greater<simEvent> > eventQueue;
 
 //system
 unsigned int memLocation;
 string inputFileName;
 char logTo;
-int quantumTime;
 int totalTime;
 int totalCount;
 int processID;
-pthread_mutex_t mtx;
-pthread_mutex_t mtx2;
+int checkTime = 0;
 bool isReset = false;
 
+//device worker pool, one queue and one long lived thread per device and processor
+const int DEVICEhdd = 0;
+const int DEVICEprojector = 1;
+const int DEVICEkeyboard = 2;
+const int DEVICEmonitor = 3;
+const int DEVICEscanner = 4;
+const int DEVICEcpu = 5; //the processors are run like devices, one unit per core
+const int NUMdevices = 6;
+const char* deviceNames[NUMdevices] = {"Hard drive", "Projector", "Keyboard", "Monitor", "Scanner", "Processor"};
+
+//hard drive request scheduling
+const int DISKfcfs = 0;
+const int DISKsstf = 1;
+const int DISKscan = 2;
+const int DISKclook = 3;
+int diskPolicy = DISKfcfs;
+int diskCylinders = 200;
+
+//meta-data operations, one table entry drives parsing, device dispatch and output
+const int OPstart = 0;
+const int OPfinish = 1;
+const int OPrun = 2;
+const int OPallocate = 3;
+const int OPblock = 4;
+const int OPmonitor = 5;
+const int OPprojector = 6;
+const int OPhddOut = 7;
+const int OPkeyboard = 8;
+const int OPhddIn = 9;
+const int OPscanner = 10;
+const int NUMops = 11;
+const opDescriptor opTable[NUMops] =
+{
+	{'A', "begin", NULL, -1, "OS: preparing process", "OS: starting process", ""},
+	{'A', "finish", NULL, -1, "End process", "", ""},
+	{'P', "run", &configData::pct, -1, "start processing action", "end processing action", ""},
+	{'M', "allocate", &configData::mct, -1, "allocating memory", "memory allocated at", ""},
+	{'M', "block", &configData::mct, -1, "start memory blocking", "end memory blocking", ""},
+	{'O', "monitor", &configData::mdt, DEVICEmonitor, "start monitor output", "end monitor output", ""},
+	{'O', "projector", &configData::pjct, DEVICEprojector, "start projector output", "end projector output", "PROJ"},
+	{'O', "hard drive", &configData::hdct, DEVICEhdd, "start hard drive output", "end hard drive output", "HDD"},
+	{'I', "keyboard", &configData::kct, DEVICEkeyboard, "start keyboard input", "end keyboard input", ""},
+	{'I', "hard drive", &configData::hdct, DEVICEhdd, "start hard drive input", "end hard drive input", "HDD"},
+	{'I', "scanner", &configData::sct, DEVICEscanner, "start scanner input", "end scanner input", ""}
+};
+vector<deviceQueue*> devicePool[NUMdevices];
+vector<int> deviceHeap[NUMdevices]; //units of each device by earliest availability
+queue<pair<ioJob*, bool> > completedJobs; //finished jobs, and jobs a worker has just started (true) so their start lines are logged in time order
+pthread_mutex_t jobMtx;
+pthread_cond_t jobDone;
+int jobsInFlight = 0;
+bool poolRunning = false;
+long dispatchCount = 0;
+double dispatchTotal = 0.0;
+
+//logging, one ring of formatted text drained by a single flusher thread
+const unsigned long LOGslots = 4096; //power of two
+const int LOGslotSize = 256;
+const int FLUSHline = 0; //flush every line like endl did
+const int FLUSHbatch = 1; //flush whenever the ring is drained
+const int FLUSHexit = 2; //let the stream buffer fill, flush at the end
+int logFlush = FLUSHbatch;
+logSlot* logRing = NULL;
+atomic<unsigned long> logHead(0);
+unsigned long logTail = 0; //flusher thread only
+atomic<bool> logRunning(false);
+ofstream logFile;
+pthread_t logThread;
+long formatCount = 0;
+double formatTotal = 0.0; //wall time spent formatting output() lines
+long parseBytes = 0;
+double parseTime = 0.0; //wall time spent scanning meta-data
+
+//compiled meta-data, kept beside the source as <file>.mdb and mapped instead of parsed while the source is unchanged
+const char COMPILEDmagic[8] = {'S', 'i', 'm', '0', '5', 'M', 'D', '1'};
+const int COMPILEDcycleBits = 28; //each command is packed as its op above its cycles
+int metaCache = 0; //0 off, 1 on
+bool metaCompiled = false; //this run's meta-data came from the compiled file
+
+//streaming meta-data, applications are read while the window has room and released at A{finish}
+const int STREAMbuffer = 65536; //first buffer size, doubled only for an application longer than it
+const int STREAMdescriptor = 32; //longest descriptor kept, longer ones are not operations
+int metaStream = 0; //0 off, 1 on, turned on for meta-data that is not a regular file
+int streamWindow = 64; //applications admitted and not yet finished
+int streamFd = -1;
+bool streamOpen = false; //more applications may come
+bool streamEnded = false; //end of file read, the buffer holds the rest of the stream
+bool streamPartial = false; //the buffer ends part way through an application, nothing to parse until more comes in
+vector<char> streamBuffer; //read and not yet admitted, a partly written application waits here
+int streamPos = 0;
+int streamLength = 0;
+int streamLive = 0;
+vector<int> freeProcesses; //released process and program slots, reused by the next application
+double streamTurnaround = 0.0; //totals over the released processes
+double streamWaiting = 0.0;
+double streamResponse = 0.0;
+ofstream streamMetrics; //per process rows are written as processes are released
+
+//trace export, the scheduler fills one buffer of raw records while a writer thread formats and writes the other
+const unsigned int TRACErecords = 8192;
+const unsigned int TRACEbuffer = 262144; //JSON text written at a time
+const int TRACEunits = 1000; //track id is device*TRACEunits + unit
+const int TRACEspan = 0; //a job on a processor or device track
+const int TRACEready = 1; //time on a ready queue, ended by a dispatch
+const int TRACEexit = 2;
+const int TRACEname = 3; //names a process track
+bool traceOn = false;
+bool traceFirst = true;
+traceRecord* traceBuffer = NULL; //being filled by the scheduler
+unsigned int traceLength = 0;
+traceRecord* traceSpare = NULL; //free for the next swap, NULL while the writer holds it
+traceRecord* traceFull = NULL; //handed to the writer, NULL once written
+unsigned int traceFullLength = 0;
+char* traceOut = NULL; //JSON text, the writer's own
+bool traceRunning = false;
+pthread_mutex_t traceMtx;
+pthread_cond_t traceReady;
+pthread_t traceThread;
+ofstream traceFile;
+
 //scheduling
 bool strs = false; //shortest time first scheduling
 bool rrs = false; //round robin scheduling
 
 //master queue
-priority_queue<processData, vector<processData>, less<processData> > strQueue;
-queue<processData> rrQueue;
-queue<processData> masterQueue;
+vector<coreData> cores; //one per processor, each with its own run queue
+long quantumCount = 0; //quanta that ran out
+long preemptCount = 0; //processes that gave up the processor to a shorter one
+double quantumOverhead = 0.0; //wall time from an interrupt to the next process starting
+long finishedCount = 0;
+deque<processData> processTable; //deque so references stay good while processes are added
+deque<programData> programs; //deque so processes can point into it while it grows
+vector<programData*> masterPrograms; //finished programs read from the meta-data, copied by loadProcess()
+
+//config file keys, one "Key {unit}: value" per line
+const int CONFIGnumber = 0; //whole number, in msec if it has a unit
+const int CONFIGmemory = 1; //size in kbytes, Mbytes or Gbytes, kept in kbytes
+const int CONFIGtext = 2; //the rest of the line
+const int CONFIGchoice = 3;
+const int CONFIGlog = 4; //where the log goes
+const int CONFIGscheduling = 5; //RR or STR
+const int CONFIGclock = 6; //the clock modes, Deterministic also turns off host timings
+const int CONFIGignore = 7;
+const int NUMconfigKeys = 31;
+const configKey configTable[NUMconfigKeys] =
+{
+	{"version/phase", CONFIGignore, NULL, NULL, "", 0},
+	{"file path", CONFIGtext, NULL, &tempConfig.inputFile, "", 0},
+	{"log file path", CONFIGtext, NULL, &tempConfig.logFile, "", 0},
+	{"trace file path", CONFIGtext, NULL, &tempConfig.traceFile, "", 0},
+	{"metrics file path", CONFIGtext, NULL, &tempConfig.metricsFile, "", 0},
+	{"processor quantum number", CONFIGnumber, &tempConfig.pqn, NULL, "", 1},
+	{"cpu scheduling code", CONFIGscheduling, NULL, NULL, "RR|STR", 0},
+	{"processor cycle time", CONFIGnumber, &tempConfig.pct, NULL, "", 0},
+	{"monitor display time", CONFIGnumber, &tempConfig.mdt, NULL, "", 0},
+	{"hard drive cycle time", CONFIGnumber, &tempConfig.hdct, NULL, "", 0},
+	{"projector cycle time", CONFIGnumber, &tempConfig.pjct, NULL, "", 0},
+	{"keyboard cycle time", CONFIGnumber, &tempConfig.kct, NULL, "", 0},
+	{"scanner cycle time", CONFIGnumber, &tempConfig.sct, NULL, "", 0},
+	{"memory cycle time", CONFIGnumber, &tempConfig.mct, NULL, "", 0},
+	{"system memory", CONFIGmemory, &tempMemory.total, NULL, "", 0},
+	{"memory block size", CONFIGmemory, &tempMemory.blockSize, NULL, "", 0},
+	{"projector quantity", CONFIGnumber, &tempConfig.numProj, NULL, "", 0},
+	{"hard drive quantity", CONFIGnumber, &tempConfig.numHDD, NULL, "", 0},
+	{"processor quantity", CONFIGnumber, &tempConfig.numCores, NULL, "", 1},
+	{"memory allocation", CONFIGchoice, &memoryPolicy, NULL, "First|Best|Buddy", 0},
+	{"memory paging", CONFIGchoice, &pagingPolicy, NULL, "Off|FIFO|LRU|Clock", 0},
+	{"tlb entries", CONFIGnumber, &tlbSize, NULL, "", 0},
+	{"pages per process", CONFIGnumber, &processPages, NULL, "", 1},
+	{"hard drive scheduling", CONFIGchoice, &diskPolicy, NULL, "FCFS|SSTF|SCAN|C-LOOK", 0},
+	{"hard drive cylinders", CONFIGnumber, &diskCylinders, NULL, "", 1},
+	{"simulation clock", CONFIGclock, NULL, NULL, "Spin|Virtual|Real|Deterministic", 0},
+	{"log", CONFIGlog, NULL, NULL, "Log to Monitor|Log to File|Log to Both", 0},
+	{"log flush policy", CONFIGchoice, &logFlush, NULL, "Line|Batch|Exit", 0},
+	{"meta-data cache", CONFIGchoice, &metaCache, NULL, "Off|On", 0},
+	{"meta-data stream", CONFIGchoice, &metaStream, NULL, "Off|On", 0},
+	{"stream window", CONFIGnumber, &streamWindow, NULL, "", 1}
+};
 
 //-------------------------
 //function declarations
 //-------------------------
 void readConfig(char*) throw(runtime_error);
 void readInput(string) throw(runtime_error);
-void output(string, string, string, int, double, double);
-void memoryAllocate();
-void timerProcess(processData);
-void simulateProcess(string);
-void* rrThread(void*);
-void* loadThread(void*);
+const configKey* findConfigKey(const string&);
+int configChoice(const configKey&, const string&);
+int configNumber(const string&, const string&) throw(runtime_error);
+string configNormal(const string&);
+void finishProgram(programData*);
+void programTimes(programData&);
+unsigned long long metaHash(const char*, size_t);
+bool loadCompiled(string, unsigned long long, size_t);
+void writeCompiled(string, unsigned long long, size_t, unsigned int);
+void startStream(int) throw(runtime_error);
+void streamAdmit(bool) throw(runtime_error);
+int streamProgram(programData&) throw(runtime_error);
+bool streamToken(char&, char*, int&, int&) throw(runtime_error);
+int streamPeek();
+bool streamFill(bool) throw(runtime_error);
+void releaseProcess(int);
+void metricsRow(ofstream&, const processData&);
+void runSimulation();
+void runBenchmarks(string, string) throw(runtime_error);
+void benchStage(vector<benchResult>&, int) throw(runtime_error);
+void benchRun(int, benchResult&);
+void benchRecord(vector<benchResult>&, const char*, long, double, long);
+void runBatch(string, string) throw(runtime_error);
+void batchRun(unsigned int, runSummary&);
+string csvField(const string&);
+void runSweep(string, string) throw(runtime_error);
+void sweepRun(unsigned int, runSummary&);
+void sweepValues(string, vector<int>&) throw(runtime_error);
+runSummary* forkRuns(unsigned int, void (*)(unsigned int, runSummary&), long&) throw(runtime_error);
+void summarizeRun(runSummary&);
+void applyCycleTimes();
+void output(string, int, int, double, double, int);
+void outputStart(ioJob*);
+void startMemory();
+int memoryAllocate(int, int);
+int memoryTake(int, int&);
+void memoryRelease(processData&);
+void memoryGive(int);
+void holeInsert(int, int);
+void holeErase(map<int, int>::iterator);
+int largestHole();
+int memoryFree();
+void startPaging();
+void pageAccess(int, int);
+int pageFrame();
+int pageVictim();
+void pageEvict(int);
+void tlbInvalidate(int, int);
+void pageRelease(processData&);
+void runScheduler();
+void startCores();
+void dispatchCore(int);
+int nextReady(int);
+int queueLength(int);
+void timerProcess(int);
+void interruptProcess(int);
+int newProcess(const programData*);
+void readyProcess(int);
+void rrPush(int, int);
+int rrPop(int);
+int timeRemaining(const processData&);
+bool strLess(int, int);
+void strPush(int, int);
+int strPop(int);
+void strPreempt(int);
+void strSiftUp(int, int);
+void strSiftDown(int, int);
+void nextCommand(processData&);
+bool processDone(const processData&);
+void simulateProcess(processData&, int, bool);
 void* ioProcess(void*);
+void startDevicePool();
+void stopDevicePool();
+void submitIO(ioJob*);
+void startVirtualIO(deviceQueue*, ioJob*);
+void queueJob(deviceQueue*, ioJob*);
+ioJob* nextJob(deviceQueue*);
+void completeIO();
+void waitIO();
+int deviceUnit(int, int);
+bool deviceLess(int, int, int);
+void deviceSiftDown(int, int);
+int opCycleTime(int, int);
+int findOp(char, const char*, int);
+double wallTime();
 void loadProcess();
-void nonIOProcess();
-void delay (int);
+int runCycle(ioJob*);
+void scheduleEvent(double, int, ioJob*);
+int advanceClock();
+bool eventDue();
+double currentTime();
+void delay(double, int);
 void startOutput(string);
 void endOutput(string);
-bool operator>(processData, processData);
-bool operator<(processData, processData);
+void metricLine(stringstream&, double, const char*, vector<double>&);
+double percentile(const vector<double>&, double);
+void writeMetrics(string);
+void startLogger(string);
+void stopLogger();
+void logWrite(string);
+void logWrite(const char*, int);
+void* logFlusher(void*);
+void logEmit(string&, bool);
+void startTrace(string);
+void stopTrace();
+void traceEvent(const char*, int);
+void* traceWriter(void*);
+void traceWrite(traceRecord*, unsigned int);
+char* traceFormat(char*, const traceRecord&);
+traceRecord* traceReserve();
+char* traceText(char*, const char*);
+char* traceNumber(char*, long);
+void traceOperation(ioJob*);
+void setState(int, int);
+bool operator>(const processData&, const processData&);
+bool operator>(simEvent, simEvent);
 
 //----------------------------------------------------------------------------------------------------
 //main driver
 //----------------------------------------------------------------------------------------------------
 
 /**
-@brief  main function, calls 3 other functions to read config, read input and output to file
-@param  command line arguments for the config file name
+@brief  main function, calls 3 other functions to read config, read input and run the simulation, or runs the benchmarks with --bench, a manifest of configs with --batch or a quantum sweep with --sweep
+@param  command line arguments for the config file name, or --bench, the config file name and the results file name, or --batch, the manifest file name and the summary file name, or --sweep, the config file name, the quanta and the processor cycle times
 @return  returns 0 to end program
-@pre  readConfig(), readInput(), output()
+@pre  readConfig(), readInput(), runSimulation()
 @post  takes the config and input information and outputs them to a file
 **/
 int main(int argc, char* argv[])
 {
+	if(argc > 2 && string(argv[1]) == "--bench")
+	{
+		readConfig(argv[2]);
+		runBenchmarks(tempConfig.inputFile, (argc > 3) ? argv[3] : "bench.json");
+		return 0;
+	}
+	
+	if(argc > 2 && string(argv[1]) == "--batch")
+	{
+		runBatch(argv[2], (argc > 3) ? argv[3] : "batch.csv");
+		return 0;
+	}
+	
+	if(argc > 3 && string(argv[1]) == "--sweep")
+	{
+		readConfig(argv[2]);
+		runSweep(argv[3], (argc > 4) ? argv[4] : "");
+		return 0;
+	}
+	
 	readConfig(argv[1]);
 	readInput(tempConfig.inputFile);
+	runSimulation();
 	return 0;
 }
 
@@ -157,19 +698,17 @@ int main(int argc, char* argv[])
 //----------------------------------------------------------------------------------------------------
 
 /**
-@brief  a function that reads in the config file the user passes, and stores the data into a global struct
+@brief  a function that reads in the config file the user passes one line at a time, looking each key up in configTable, and stores the data into a global struct
 @param  string filename
 @return  none
 @pre  none
-@post  stores config data into global struct
+@post  stores config data into global struct, throws on a key, unit or value it does not know
 **/
 void readConfig(char* filename) throw(runtime_error)
 {
 	//open file
-	ifstream fin;
-	fin.open(filename);
-	queue<string> tempQ;
-	string tempS;
+	ifstream fin(filename);
+	string line;
 	
 	//check if file exists
 	if(!fin.good())
@@ -177,1252 +716,4754 @@ void readConfig(char* filename) throw(runtime_error)
 		throw runtime_error("config file not found");
 	}
 	
-	//read in a configuration file
-	while(fin.good())
-	{
-		fin >> tempS; 
-		tempQ.push(tempS);
-	}
-	
-	//close file
-	fin.close();
-	
-	//store file data into global struct
-	while(!tempQ.empty())
+	//lines without a colon are the start and end markers
+	while(getline(fin, line))
 	{
-		string tempS = tempQ.front();
-		int val = 0;
+		size_t colon = line.find(':');
 		
-		if (tempS == "Path:")
+		if(colon == string::npos)
 		{
-			for(int i = 0; i < 1; i++)
-			{
-				tempQ.pop();
-			}
-			
-			tempConfig.inputFile = tempQ.front();
+			continue;
 		}
 		
-		if (tempS == "Monitor")
+		string key = line.substr(0, colon);
+		string value = line.substr(colon + 1);
+		string unit;
+		size_t first = value.find_first_not_of(" \t\r");
+		size_t last = value.find_last_not_of(" \t\r");
+		value = (first == string::npos) ? "" : value.substr(first, last - first + 1);
+		
+		//unit in braces, the key is the text before it
+		size_t brace = key.find('{');
+		
+		if(brace != string::npos)
 		{
-			for(int i = 0; i < 4; i++)
+			size_t closing = key.find('}', brace);
+			
+			if(closing == string::npos)
 			{
-				tempQ.pop();
+				throw runtime_error("config unit is missing a } in " + line);
 			}
 			
-			stringstream tempMDT(tempQ.front());
-			tempMDT >> val;
-			tempConfig.mdt = val;
+			unit = configNormal(key.substr(brace + 1, closing - brace - 1));
+			key.erase(brace);
 		}
 		
-		if (tempS == "Processor")
+		const configKey* tempKey = findConfigKey(configNormal(key));
+		
+		if(tempKey == NULL)
 		{
-			tempQ.pop();
-			
-			//processor quantum number
-			if (tempQ.front() == "Quantum")
-			{
-				for(int i = 0; i < 3; i++)
-				{	
-					tempQ.pop();
-				}
-				
-				stringstream tempPQN(tempQ.front());
-				tempPQN >> val;
-				tempConfig.pqn = val;
-			}
-			
-			else
-			{
-				for(int i = 0; i < 3; i++)
-				{
-					tempQ.pop();
-				}
-			
-				stringstream tempPCT(tempQ.front());
-				tempPCT >> val;
-				tempConfig.pct = val;
-			}
+			throw runtime_error("unknown config key in " + line);
 		}
 		
-		if (tempS == "Scanner")
+		if(!unit.empty() && unit != "msec" && tempKey->type != CONFIGmemory)
 		{
-			for(int i = 0; i < 4; i++)
-			{
-				tempQ.pop();
-			}
-			
-			stringstream tempSCT(tempQ.front());
-			tempSCT >> val;
-			tempConfig.sct = val;
+			throw runtime_error("config unit error in " + line);
 		}
 		
-		if (tempS == "Hard")
+		if(tempKey->type == CONFIGnumber || tempKey->type == CONFIGmemory)
 		{
-			for(int i = 0; i < 5; i++)
+			int val = configNumber(value, line);
+			
+			//memory is kept in kbytes
+			if(tempKey->type == CONFIGmemory)
 			{
-				tempQ.pop();
+				if(unit == "mbytes")
+				{
+					val *= 1024;
+				}
+				
+				else if(unit == "gbytes")
+				{
+					val *= 1024*1024;
+				}
+				
+				else if(!unit.empty() && unit != "kbytes")
+				{
+					throw runtime_error("config unit error in " + line);
+				}
 			}
 			
-			stringstream tempHDCT(tempQ.front());
-			tempHDCT >> val;
-			tempConfig.hdct = val;
-		}
-		
-		if (tempS == "Keyboard")
-		{
-			for(int i = 0; i < 4; i++)
+			if(val < tempKey->minimum)
 			{
-				tempQ.pop();
+				throw runtime_error("config value out of range in " + line);
 			}
 			
-			stringstream tempKCT(tempQ.front());
-			tempKCT >> val;
-			tempConfig.kct = val;
+			*tempKey->number = val;
 		}
 		
-		if (tempS == "Memory")
+		else if(tempKey->type == CONFIGtext)
 		{
-			for(int i = 0; i < 4; i++)
-			{
-				tempQ.pop();
-			}
-			
-			stringstream tempMCT(tempQ.front());
-			tempMCT >> val;
-			tempConfig.mct = val;
+			*tempKey->text = value;
 		}
 		
-		if (tempS == "Projector")
+		else if(tempKey->type != CONFIGignore)
 		{
-			tempQ.pop();
+			int choice = configChoice(*tempKey, value);
 			
-			//checks the number of projectors and hard drives
-			if (tempQ.front() == "quantity:")
+			//any scheduling code other than STR is round robin
+			if(choice < 0 && tempKey->type != CONFIGscheduling)
 			{
-				tempQ.pop();
-				int val;
-				string tempVal = tempQ.front();
-				stringstream tempPRPV(tempVal);
-				tempPRPV >> val;
-				tempConfig.numProj = val;
-		
-				for(int i = 0; i < 4; i++)
-				{
-					tempQ.pop();
-				}
-		
-				string tempVal2 = tempQ.front();
-				stringstream tempPRPV2(tempVal2);
-				tempPRPV2 >> val;
-				tempConfig.numHDD = val;
+				throw runtime_error("config value error in " + line);
 			}
 			
-			else
+			if(tempKey->type == CONFIGchoice)
 			{
-				for(int i = 0; i < 3; i++)
-				{
-					tempQ.pop();
-				}
-				stringstream tempPJCT(tempQ.front());
-				tempPJCT >> val;
-				tempConfig.pjct = val;
-			}
-		}
-		
-		//log if monitor, file or both
-		if (tempS == "Log")
-		{
-			for(int i = 0; i < 2; i++)
-			{	
-				tempQ.pop();
+				*tempKey->number = choice;
 			}
 			
-			if (tempQ.front() == "Monitor")
+			//log if monitor, file or both
+			else if(tempKey->type == CONFIGlog)
 			{
-				logTo = 'M';
-				
-				for(int i = 0; i < 4; i++)
-				{
-					tempQ.pop();
-				}
-				
-				tempConfig.logFile = tempQ.front();
+				logTo = "MFB"[choice];
 			}
 			
-			else if (tempQ.front() == "File")
+			//cpu scheduling
+			else if(tempKey->type == CONFIGscheduling)
 			{
-				logTo = 'F';
-				
-				for(int i = 0; i < 4; i++)
-				{
-					tempQ.pop();
-				}
-				
-				tempConfig.logFile = tempQ.front();
+				strs = (choice == 1);
+				rrs = !strs;
 			}
 			
-			else if (tempQ.front() == "Both")
+			//virtual clock without the host timings, so two runs give the same log
+			else if(choice == 3)
 			{
-				logTo = 'B';
-				
-				for(int i = 0; i < 4; i++)
-				{
-					tempQ.pop();
-				}
-				
-				tempConfig.logFile = tempQ.front();
+				clockMode = CLOCKvirtual;
+				hostTimings = false;
 			}
-				
-			//output if log is incorrect
+			
 			else
 			{
-				throw runtime_error("log error");
+				clockMode = choice;
 			}
 		}
-		
-		//system and block sizes
-		if(tempS == "System")
+	}
+	
+	//close file
+	fin.close();
+}
+
+/**
+@brief  looks up a config key
+@param  const string &key, lower case with single spaces
+@return  const configKey* its entry in configTable, NULL if there is none
+@pre  configNormal()
+@post  none
+**/
+const configKey* findConfigKey(const string& key)
+{
+	for(int i = 0; i < NUMconfigKeys; i++)
+	{
+		if(key == configTable[i].key)
 		{
-			for(int i = 0; i < 2; i++)
-			{
-				tempQ.pop();
-			}
-					
-			//checking system memory size
-			if (tempQ.front() == "{kbytes}:")
-			{
-				tempQ.pop();
-				int val;
-				string tempVal = tempQ.front();
-				stringstream tempPRPV(tempVal);
-				tempPRPV >> val;
-				tempMemory.total = val;
-				
-				for(int i = 0; i < 4; i++)
-				{
-					tempQ.pop();
-				}
-				
-				if (tempQ.front() == "{kbytes}:")
-				{
-					tempQ.pop();
-					string tempVal2 = tempQ.front();
-					stringstream tempPRPV2(tempVal2);
-					tempPRPV2 >> val;
-					tempMemory.blockSize = val;
-				}
-			}
-			
-			else if (tempQ.front() == "{Mbytes}:")
-			{
-				tempQ.pop();
-				int val;
-				string tempVal = tempQ.front();
-				stringstream tempPRPV(tempVal);
-				tempPRPV >> val;
-				tempMemory.total = (val*1024);
-				
-				for(int i = 0; i < 4; i++)
-				{
-					tempQ.pop();
-				}
-				
-				if (tempQ.front() == "{Mbytes}:")
-				{
-					tempQ.pop();
-					string tempVal2 = tempQ.front();
-					stringstream tempPRPV2(tempVal2);
-					tempPRPV2 >> val;
-					tempMemory.blockSize = (val*1024);
-				}
-			}
-		
-			else if (tempQ.front() == "{Gbytes}:")
-			{
-				tempQ.pop();
-				int val;
-				string tempVal = tempQ.front();
-				stringstream tempPRPV(tempVal);
-				tempPRPV >> val;
-				tempMemory.total = (val*1024*1024);
-				
-				for(int i = 0; i < 4; i++)
-				{
-					tempQ.pop();
-				}
-				
-				if (tempQ.front() == "{Gbytes}:")
-				{
-					tempQ.pop();
-					string tempVal2 = tempQ.front();
-					stringstream tempPRPV2(tempVal2);
-					tempPRPV2 >> val;
-					tempMemory.blockSize = (val*1024*1024);
-				}
-			}
+			return &configTable[i];
+		}
+	}
+	
+	return NULL;
+}
+
+/**
+@brief  finds a value among a key's choices, ignoring case and spacing
+@param  const configKey &tempKey, const string &value
+@return  int index of the choice, -1 if it is not one
+@pre  findConfigKey()
+@post  none
+**/
+int configChoice(const configKey& tempKey, const string& value)
+{
+	string given = configNormal(value);
+	stringstream choices(tempKey.choices);
+	string choice;
+	int index = 0;
+	
+	while(getline(choices, choice, '|'))
+	{
+		if(configNormal(choice) == given)
+		{
+			return index;
 		}
 		
-		//cpu scheduling
-		if (tempS == "CPU")
+		index++;
+	}
+	
+	return -1;
+}
+
+/**
+@brief  reads a whole number config value
+@param  const string &value, const string &line for the error
+@return  int
+@pre  none
+@post  throws unless the whole value is a number
+**/
+int configNumber(const string& value, const string& line) throw(runtime_error)
+{
+	char* end = NULL;
+	long val = strtol(value.c_str(), &end, 10);
+	
+	if(value.empty() || *end != '\0' || val > 2147483647L || val < -2147483647L)
+	{
+		throw runtime_error("config value is not a whole number in " + line);
+	}
+	
+	return (int)val;
+}
+
+/**
+@brief  lower cases text and squeezes its spacing to single spaces, so keys and choices match however they are typed
+@param  const string &text
+@return  string
+@pre  none
+@post  none
+**/
+string configNormal(const string& text)
+{
+	string normal;
+	
+	for(unsigned int i = 0; i < text.size(); i++)
+	{
+		if(isspace((unsigned char)text[i]))
 		{
-			for(int i = 0; i < 3; i++)
-			{
-				tempQ.pop();
-			}
-			
-			if(tempQ.front() == "STR")
+			if(!normal.empty() && normal[normal.size() - 1] != ' ')
 			{
-				strs = true;
-			}
-			
-			else
-			{
-				rrs = true;
+				normal += ' ';
 			}
 		}
 		
 		else
 		{
-			tempQ.pop();
+			normal += (char)tolower((unsigned char)text[i]);
 		}
 	}
+	
+	if(!normal.empty() && normal[normal.size() - 1] == ' ')
+	{
+		normal.erase(normal.size() - 1);
+	}
+	
+	return normal;
 }
 
 /**
-@brief  a function that reads in the user defined meta-data input file and stores information into a global struct
+@brief  a function that maps the user defined meta-data input file, scans it in a single pass and stores information into a global struct
 @param  string filename
 @return  none
 @pre  none
-@post  stores meta-data into a queue depending on scheduling and stores the calculated cycle time into another
+@post  stores meta-data into a queue depending on scheduling and stores the calculated cycle time into another, loads or writes the compiled file instead when the meta-data cache is on, or starts streaming it
 **/
 void readInput(string filename) throw(runtime_error)
 {	
-	//open file
-	ifstream fin;
-	fin.open(filename.c_str());
-	string tempS;
+	//map the file, it is scanned in place, - is standard input
+	int fd = (filename == "-") ? 0 : open(filename.c_str(), O_RDONLY);
+	struct stat fileInfo;
 	
 	//check if file exists
-	if(!fin.good())
+	if(fd < 0 || fstat(fd, &fileInfo) != 0)
 	{
 		throw runtime_error("meta-data file not found");
 	}
 	
-	//read in input file
-	while(fin.good())
+	//pipes and terminals cannot be mapped, they are read as the simulation goes
+	if(!S_ISREG(fileInfo.st_mode) || metaStream == 1)
+	{
+		startStream(fd);
+		return;
+	}
+	
+	size_t size = fileInfo.st_size;
+	const char* data = NULL;
+	
+	if(size > 0)
+	{
+		data = (const char*)mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+		
+		if(data == MAP_FAILED)
+		{
+			close(fd);
+			throw runtime_error("meta-data file could not be mapped");
+		}
+	}
+	
+	//processes are queued on a processor as soon as they are parsed
+	startCores();
+	startMemory();
+	startPaging();
+	
+	double parseStart = wallTime();
+	unsigned int firstProgram = programs.size();
+	unsigned long long hash = 0;
+	
+	//the compiled file stands in for the source until the source changes
+	if(metaCache == 1)
+	{
+		hash = metaHash(data, size);
+		metaCompiled = loadCompiled(filename + ".mdb", hash, size);
+	}
+	
+	const char* cursor = metaCompiled ? data + size : data;
+	const char* end = data + size;
+	bool inApplication = false;
+	programData* tempProgram = NULL;
+	
+	//read in input file one X{descriptor}N token at a time
+	while(cursor < end)
 	{
-		fin >> tempS; 
-		string tempCutStr = tempS.substr(0, 3);
-		string tempVal;
-		int val, bracket, semiColon;
-		processData tempProcess;
+		const char* bracket = (const char*)memchr(cursor, '{', end - cursor);
+		
+		if(bracket == NULL)
+		{
+			break;
+		}
+		
+		const char* closing = (const char*)memchr(bracket, '}', end - bracket);
+		
+		if(closing == NULL)
+		{
+			munmap((void*)data, size);
+			close(fd);
+			throw runtime_error("meta-data is missing a }");
+		}
+		
+		char code = (bracket > data) ? bracket[-1] : ' ';
+		const char* descriptor = bracket + 1;
+		int length = closing - descriptor;
+		int val = 0;
+		cursor = closing + 1;
+		
+		while(cursor < end && *cursor >= '0' && *cursor <= '9')
+		{
+			val = (val*10) + (*cursor - '0');
+			cursor++;
+		}
+		
+		int op = findOp(code, descriptor, length);
 		
 		//application(start)
-		if(tempCutStr == "A{b")
-		{	
-			inputData tempInput;
-			tempProcess.countTask = 0;
-			tempProcess.countIO = 0;
-			tempInput.opCode = "application";
-			tempInput.opCommand = "start";
-			tempInput.cycleTime = 1;
-			tempProcess.commands.push(tempInput);
-			
-			while(tempCutStr != "A{f")
+		if(op == OPstart)
+		{
+			//the unfinished program would be spawned without its cycle times
+			if(inApplication)
 			{
-				fin >> tempS;
-				tempCutStr = tempS.substr(0, 3);
-				
-				//processor(run)
-				if(tempCutStr == "P{r")
-				{
-					bracket = tempS.find("}");
-					semiColon = tempS.find(";");
-					tempVal = tempS.substr(bracket+1, ((semiColon-bracket) - 1));
-			
-					stringstream tempPRPV(tempVal);
-					tempPRPV >> val;
-					inputData tempInput;
-					tempInput.opCode = "processor";
-					tempInput.opCommand = "run";
-					tempInput.cycleTime = (val*tempConfig.pct);
-					tempProcess.commands.push(tempInput);
-					tempProcess.countTask++;
-				}
-				
-				//memory(allocate)
-				else if(tempCutStr == "M{a")
-				{
-					bracket = tempS.find("}");
-					semiColon = tempS.find(";");
-					tempVal = tempS.substr(bracket+1, ((semiColon-bracket) - 1));
-			
-					stringstream tempMAPV(tempVal);
-					tempMAPV >> val;
-					inputData tempInput;
-					tempInput.opCode = "memory";
-					tempInput.opCommand = "allocate";
-					tempInput.cycleTime = (val*tempConfig.mct);
-					tempProcess.commands.push(tempInput);
-					tempProcess.countTask++;
-				}
-				
-				//memory(block)
-				else if(tempCutStr == "M{b")
-				{
-					bracket = tempS.find("}");
-					semiColon = tempS.find(";");
-					tempVal = tempS.substr(bracket+1, ((semiColon-bracket) - 1));
+				munmap((void*)data, size);
+				close(fd);
+				throw runtime_error("A{begin} found before A{finish}");
+			}
 			
-					stringstream tempMBPV(tempVal);
-					tempMBPV >> val;
-					inputData tempInput;
-					tempInput.opCode = "memory";
-					tempInput.opCommand = "block";
-					tempInput.cycleTime = (val*tempConfig.mct);
-					tempProcess.commands.push(tempInput);
-					tempProcess.countTask++;
-				}
-				
-				//output(monitor)
-				else if(tempCutStr == "O{m")
-				{
-					bracket = tempS.find("}");
-					semiColon = tempS.find(";");
-					tempVal = tempS.substr(bracket+1, ((semiColon-bracket) - 1));
+			inputData tempInput;
+			programs.push_back(programData());
+			tempProgram = &programs.back();
+			tempProgram->countTask = 0;
+			tempProgram->countIO = 0;
+			tempInput.op = OPstart;
+			tempInput.cycles = 0;
+			tempProgram->commands.push_back(tempInput);
+			inApplication = true;
+		}
+		
+		//application(finish)
+		else if(op == OPfinish && inApplication)
+		{
+			inputData tempInput;
+			tempInput.op = OPfinish;
+			tempInput.cycles = 0;
+			tempProgram->commands.push_back(tempInput);
+			inApplication = false;
+			finishProgram(tempProgram);
+		}
+		
+		//operations only count inside an application
+		else if(inApplication)
+		{
+			//if the process is missing A{finish}
+			if(code == 'S' && length == 6 && memcmp(descriptor, "finish", 6) == 0)
+			{
+				munmap((void*)data, size);
+				close(fd);
+				throw runtime_error("A{finish} not found before S{finish}");
+			}
 			
-					stringstream tempOMPV(tempVal);
-					tempOMPV >> val;
-					inputData tempInput;
-					tempInput.opCode = "output";
-					tempInput.opCommand = "monitor";
-					tempInput.cycleTime = (val*tempConfig.mdt);
-					tempProcess.commands.push(tempInput);
-					tempProcess.countIO++;
-					tempProcess.countTask++;
-				}
-				
-				//output(projector)
-				else if(tempCutStr == "O{p")
-				{
-					bracket = tempS.find("}");
-					semiColon = tempS.find(";");
-					tempVal = tempS.substr(bracket+1, ((semiColon-bracket) - 1));
+			if(op < 0)
+			{
+				munmap((void*)data, size);
+				close(fd);
+				throw runtime_error("unknown meta-data operation " + string(1, code) + "{" + string(descriptor, length) + "}");
+			}
 			
-					stringstream tempOPPV(tempVal);
-					tempOPPV >> val;
-					inputData tempInput;
-					tempInput.opCode = "output";
-					tempInput.opCommand = "projector";
-					tempInput.cycleTime = (val*tempConfig.pjct);
-					tempProcess.commands.push(tempInput);
-					tempProcess.countIO++;
-					tempProcess.countTask++;
-				}
-				
-				//output(hard drive)
-				else if(tempCutStr == "O{h")
-				{
-					fin >> tempS;
-					bracket = tempS.find("}");
-					semiColon = tempS.find(";");
-					tempVal = tempS.substr(bracket+1, ((semiColon-bracket) - 1));
+			inputData tempInput;
+			tempInput.op = op;
+			tempInput.cycles = val;
+			tempProgram->commands.push_back(tempInput);
+			tempProgram->countTask++;
 			
-					stringstream tempOHPV(tempVal);
-					tempOHPV >> val;
-					inputData tempInput;
-					tempInput.opCode = "output";
-					tempInput.opCommand = "hdd";
-					tempInput.cycleTime = (val*tempConfig.hdct);
-					tempProcess.commands.push(tempInput);
-					tempProcess.countIO++;
-					tempProcess.countTask++;
-				}
-				
-				//input(keyboard)
-				else if(tempCutStr == "I{k")
-				{
-					bracket = tempS.find("}");
-					semiColon = tempS.find(";");
-					tempVal = tempS.substr(bracket+1, ((semiColon-bracket) - 1));
+			if(opTable[op].device >= 0)
+			{
+				tempProgram->countIO++;
+			}
+		}
+	}
+	
+	//an application cut off by the end of the file never runs
+	if(inApplication)
+	{
+		programs.pop_back();
+	}
+	
+	if(metaCache == 1 && !metaCompiled)
+	{
+		writeCompiled(filename + ".mdb", hash, size, firstProgram);
+	}
+	
+	//close file
+	parseTime += wallTime() - parseStart;
+	parseBytes += size;
+	
+	if(data != NULL)
+	{
+		munmap((void*)data, size);
+	}
+	
+	close(fd);
+}
+
+/**
+@brief  works out a finished application's times and queues a process to run it
+@param  programData *tempProgram
+@return  none
+@pre  every command from A{begin} to A{finish} is in the program
+@post  the program is in masterPrograms unless it was streamed, and its process is ready
+**/
+void finishProgram(programData* tempProgram)
+{
+	//streamed programs reuse their slot, loadProcess() never copies them
+	if(metaStream == 0)
+	{
+		masterPrograms.push_back(tempProgram);
+	}
+	
+	programTimes(*tempProgram);
+	readyProcess(newProcess(tempProgram));
+}
+
+/**
+@brief  sets every command's cycle time from tempConfig and the time left from each command
+@param  programData &tempProgram
+@return  none
+@pre  readConfig()
+@post  timeLeft has one more entry than commands, the last 0, for shortest time remaining
+**/
+void programTimes(programData& tempProgram)
+{
+	tempProgram.timeLeft.assign(tempProgram.commands.size() + 1, 0);
+	
+	for(int i = tempProgram.commands.size() - 1; i >= 0; i--)
+	{
+		tempProgram.commands[i].cycleTime = opCycleTime(tempProgram.commands[i].op, tempProgram.commands[i].cycles);
+		tempProgram.timeLeft[i] = tempProgram.timeLeft[i + 1] + tempProgram.commands[i].cycleTime;
+	}
+}
+
+/**
+@brief  64 bit FNV-1a hash of the source meta-data, what a compiled file is checked against
+@param  const char *data, size_t size
+@return  unsigned long long
+@pre  none
+@post  none
+**/
+unsigned long long metaHash(const char* data, size_t size)
+{
+	unsigned long long hash = 14695981039346656037ULL;
+	
+	for(size_t i = 0; i < size; i++)
+	{
+		hash = (hash ^ (unsigned char)data[i])*1099511628211ULL;
+	}
+	
+	return hash;
+}
+
+/**
+@brief  maps a compiled meta-data file and loads its applications, if it was compiled from the same source
+@param  string filename, unsigned long long hash, size_t size of the source
+@return  bool true if the applications were loaded, false if there is no usable compiled file
+@pre  startCores()
+@post  cycle times come from tempConfig, so one compiled file serves every config
+**/
+bool loadCompiled(string filename, unsigned long long hash, size_t size)
+{
+	int fd = open(filename.c_str(), O_RDONLY);
+	struct stat fileInfo;
+	
+	if(fd < 0)
+	{
+		return false;
+	}
+	
+	if(fstat(fd, &fileInfo) != 0 || (size_t)fileInfo.st_size < sizeof(compiledHeader))
+	{
+		close(fd);
+		return false;
+	}
+	
+	size_t length = fileInfo.st_size;
+	const char* data = (const char*)mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	
+	if(data == MAP_FAILED)
+	{
+		return false;
+	}
+	
+	//stale, truncated or from another layout, it will be compiled again
+	const compiledHeader* header = (const compiledHeader*)data;
+	const unsigned int* offsets = (const unsigned int*)(data + sizeof(compiledHeader));
+	const unsigned int* packed = offsets + header->programs + 1;
+	bool usable = memcmp(header->magic, COMPILEDmagic, sizeof(COMPILEDmagic)) == 0 && header->hash == hash && header->size == size && length == sizeof(compiledHeader) + (header->programs + 1 + (unsigned long long)header->commands)*sizeof(unsigned int) && offsets[0] == 0 && offsets[header->programs] == header->commands;
+	
+	for(unsigned int i = 0; i < header->programs && usable; i++)
+	{
+		usable = offsets[i] + 2 <= offsets[i + 1];
+	}
+	
+	for(unsigned int i = 0; i < header->commands && usable; i++)
+	{
+		usable = (packed[i] >> COMPILEDcycleBits) < (unsigned int)NUMops;
+	}
+	
+	if(!usable)
+	{
+		munmap((void*)data, length);
+		return false;
+	}
+	
+	for(unsigned int i = 0; i < header->programs; i++)
+	{
+		programs.push_back(programData());
+		programData* tempProgram = &programs.back();
+		tempProgram->commands.resize(offsets[i + 1] - offsets[i]);
+		tempProgram->countTask = tempProgram->commands.size() - 2;
+		tempProgram->countIO = 0;
+		
+		for(unsigned int j = 0; j < tempProgram->commands.size(); j++)
+		{
+			unsigned int command = packed[offsets[i] + j];
+			tempProgram->commands[j].op = command >> COMPILEDcycleBits;
+			tempProgram->commands[j].cycles = command & ((1U << COMPILEDcycleBits) - 1);
 			
-					stringstream tempIKPV(tempVal);
-					tempIKPV >> val;
-					inputData tempInput;
-					tempInput.opCode = "input";
-					tempInput.opCommand = "keyboard";
-					tempInput.cycleTime = (val*tempConfig.kct);
-					tempProcess.commands.push(tempInput);
-					tempProcess.countIO++;
-					tempProcess.countTask++;
-				}
+			if(opTable[tempProgram->commands[j].op].device >= 0)
+			{
+				tempProgram->countIO++;
+			}
+		}
 		
-				//input(hard drive)
-				else if(tempCutStr == "I{h")
-				{
-					fin >> tempS;
-					bracket = tempS.find("}");
-					semiColon = tempS.find(";");
-					tempVal = tempS.substr(bracket+1, ((semiColon-bracket) - 1));
+		finishProgram(tempProgram);
+	}
+	
+	munmap((void*)data, length);
+	return true;
+}
+
+/**
+@brief  writes the applications parsed from a source to a compiled meta-data file, skipped if it cannot be written
+@param  string filename, unsigned long long hash, size_t size of the source, unsigned int firstProgram parsed from it
+@return  none
+@pre  readInput()
+@post  written to a temporary file and renamed over the old one, so runs reading it at the same time see one or the other
+**/
+void writeCompiled(string filename, unsigned long long hash, size_t size, unsigned int firstProgram)
+{
+	compiledHeader header;
+	vector<unsigned int> offsets(1, 0);
+	vector<unsigned int> packed;
+	
+	for(unsigned int i = firstProgram; i < programs.size(); i++)
+	{
+		for(unsigned int j = 0; j < programs[i].commands.size(); j++)
+		{
+			//too many cycles to pack, keep parsing this one
+			if(programs[i].commands[j].cycles < 0 || programs[i].commands[j].cycles >= (1 << COMPILEDcycleBits))
+			{
+				return;
+			}
 			
-					stringstream tempIHPV(tempVal);
-					tempIHPV >> val;
-					inputData tempInput;
-					tempInput.opCode = "input";
-					tempInput.opCommand = "hdd";
-					tempInput.cycleTime = (val*tempConfig.hdct);
-					tempProcess.commands.push(tempInput);
-					tempProcess.countIO++;
-					tempProcess.countTask++;
-				}
+			packed.push_back(((unsigned int)programs[i].commands[j].op << COMPILEDcycleBits) | programs[i].commands[j].cycles);
+		}
 		
-				//input(scanner)
-				else if(tempCutStr == "I{s")
-				{
-					bracket = tempS.find("}");
-					semiColon = tempS.find(";");
-					tempVal = tempS.substr(bracket+1, ((semiColon-bracket) - 1));
+		offsets.push_back(packed.size());
+	}
+	
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, COMPILEDmagic, sizeof(COMPILEDmagic));
+	header.hash = hash;
+	header.size = size;
+	header.programs = offsets.size() - 1;
+	header.commands = packed.size();
+	
+	stringstream tempName;
+	tempName << filename << "." << getpid();
+	ofstream outFile(tempName.str().c_str(), ios::binary);
+	
+	if(!outFile.is_open())
+	{
+		return;
+	}
+	
+	outFile.write((const char*)&header, sizeof(header));
+	outFile.write((const char*)&offsets[0], offsets.size()*sizeof(unsigned int));
+	
+	if(!packed.empty())
+	{
+		outFile.write((const char*)&packed[0], packed.size()*sizeof(unsigned int));
+	}
+	
+	outFile.close();
+	
+	if(outFile.fail() || rename(tempName.str().c_str(), filename.c_str()) != 0)
+	{
+		remove(tempName.str().c_str());
+	}
+}
+
+/**
+@brief  starts reading the meta-data as a stream and admits the first window of applications
+@param  int fd, the open meta-data
+@return  none
+@pre  readConfig()
+@post  runScheduler() admits the rest as processes finish, memory stays bounded by the stream window
+**/
+void startStream(int fd) throw(runtime_error)
+{
+	metaStream = 1;
+	streamFd = fd;
+	streamOpen = true;
+	streamEnded = false;
+	streamPartial = true;
+	streamBuffer.assign(STREAMbuffer, 0);
+	streamPos = 0;
+	streamLength = 0;
+	startCores();
+	startMemory();
+	startPaging();
+	
+	if(!tempConfig.metricsFile.empty())
+	{
+		streamMetrics.open(tempConfig.metricsFile.c_str());
+		
+		if(!streamMetrics.is_open())
+		{
+			throw runtime_error("metrics file could not be opened");
+		}
+		
+		streamMetrics << "process,arrival,first_run,completion,turnaround,waiting,response" << '\n';
+		streamMetrics << fixed;
+	}
+	
+	streamAdmit(true);
+}
+
+/**
+@brief  admits the applications that have come in on the stream until the window is full, without waiting for more unless told to
+@param  bool block, wait until at least one application comes in or the stream ends
+@return  none
+@pre  startStream()
+@post  each application read is a ready process arriving now, a partly read one stays buffered, the stream is closed after S{finish} or end of file
+**/
+void streamAdmit(bool block) throw(runtime_error)
+{
+	double parseStart = wallTime();
+	int admitted = 0;
+	
+	while(streamOpen && streamLive < streamWindow)
+	{
+		//time spent waiting for the writer is not parsing
+		if(streamPartial)
+		{
+			double waitStart = wallTime();
+			bool more = streamFill(block && admitted == 0);
+			parseStart += wallTime() - waitStart;
 			
-					stringstream tempISPV(tempVal);
-					tempISPV >> val;
-					inputData tempInput;
-					tempInput.opCode = "input";
-					tempInput.opCommand = "scanner";
-					tempInput.cycleTime = (val*tempConfig.sct);
-					tempProcess.commands.push(tempInput);
-					tempProcess.countIO++;
-					tempProcess.countTask++;
-				}
-				
-				//if the process is missing A{finish}
-				else if(tempCutStr == "S{f")
-				{
-					throw runtime_error("A{finish} not found before S{finish}");
-				}	
+			if(!more)
+			{
+				break;
 			}
 			
-			//application(finish)
-			tempInput.opCode = "application";
-			tempInput.opCommand = "finish";
-			tempInput.cycleTime = 1;
-			tempProcess.commands.push(tempInput);
-			tempProcess.processCount = ++processID;
+			streamPartial = false;
+		}
+		
+		//the program goes in the slot its process will get
+		unsigned int slot = freeProcesses.empty() ? programs.size() : freeProcesses.back();
+		bool grown = slot == programs.size();
+		
+		if(grown)
+		{
+			programs.push_back(programData());
+		}
+		
+		int start = streamPos;
+		int result = streamProgram(programs[slot]);
+		
+		if(result > 0)
+		{
+			streamLive++;
+			admitted++;
+			finishProgram(&programs[slot]);
+			continue;
+		}
+		
+		if(grown)
+		{
+			programs.pop_back();
+		}
+		
+		if(result == 0)
+		{
+			streamOpen = false;
 			
-			//using shortest time first scheduling
-			if (strs == true)
+			if(streamFd != 0)
 			{
-				strQueue.push(tempProcess);
-				masterQueue.push(tempProcess);
+				close(streamFd);
 			}
+			
+			break;
+		}
+		
+		//the rest of the application has not come in, it is read again from its start once it has
+		streamPos = start;
+		streamPartial = true;
+	}
 	
-			//using round robin scheduling
-			else
-			{
-				rrQueue.push(tempProcess);
-				masterQueue.push(tempProcess);
-			}
+	parseTime += wallTime() - parseStart;
+}
+
+/**
+@brief  reads the next application from the buffered stream into a program, reusing its storage
+@param  programData &tempProgram
+@return  int 1 for an application, 0 if the stream ended before another A{begin}, -1 if the rest of it has not come in yet
+@pre  startStream()
+@post  the program holds every command from A{begin} to A{finish}, or the caller goes back to where it started
+**/
+int streamProgram(programData& tempProgram) throw(runtime_error)
+{
+	char code = ' ';
+	char descriptor[STREAMdescriptor];
+	int length = 0;
+	int val = 0;
+	
+	//anything before the application, S{begin} and S{finish} included
+	while(true)
+	{
+		if(!streamToken(code, descriptor, length, val))
+		{
+			return streamEnded ? 0 : -1;
+		}
+		
+		if(findOp(code, descriptor, length) == OPstart)
+		{
+			break;
+		}
+		
+		if(code == 'S' && length == 6 && memcmp(descriptor, "finish", 6) == 0)
+		{
+			return 0;
+		}
+	}
+	
+	inputData tempInput;
+	tempInput.op = OPstart;
+	tempInput.cycles = 0;
+	tempProgram.commands.clear();
+	tempProgram.commands.push_back(tempInput);
+	tempProgram.countTask = 0;
+	tempProgram.countIO = 0;
+	
+	while(true)
+	{
+		bool found = streamToken(code, descriptor, length, val);
+		
+		if(!found && !streamEnded)
+		{
+			return -1;
+		}
+		
+		if(!found || (code == 'S' && length == 6 && memcmp(descriptor, "finish", 6) == 0))
+		{
+			throw runtime_error("A{finish} not found before S{finish}");
+		}
+		
+		int op = findOp(code, descriptor, length);
+		
+		if(op == OPstart)
+		{
+			throw runtime_error("A{begin} found before A{finish}");
+		}
+		
+		if(op < 0)
+		{
+			throw runtime_error("unknown meta-data operation " + string(1, code) + "{" + string(descriptor, length) + "}");
+		}
+		
+		//the cycle count ran to the end of what has come in, more digits may follow
+		if(op != OPfinish && streamPos >= streamLength && !streamEnded)
+		{
+			return -1;
+		}
+		
+		tempInput.op = op;
+		tempInput.cycles = (op == OPfinish) ? 0 : val;
+		tempProgram.commands.push_back(tempInput);
+		
+		if(op == OPfinish)
+		{
+			return 1;
+		}
+		
+		tempProgram.countTask++;
+		
+		if(opTable[op].device >= 0)
+		{
+			tempProgram.countIO++;
+		}
+	}
+}
+
+/**
+@brief  reads the next X{descriptor}N token from the buffered stream
+@param  char &code, char *descriptor, int &length, int &val
+@return  bool false at the end of what has come in, which is the end of the stream once streamEnded is set
+@pre  startStream()
+@post  descriptor holds up to STREAMdescriptor characters, too long to be an operation
+**/
+bool streamToken(char& code, char* descriptor, int& length, int& val) throw(runtime_error)
+{
+	int c = 0;
+	code = ' ';
+	length = 0;
+	val = 0;
+	
+	while((c = streamPeek()) != '{')
+	{
+		if(c < 0)
+		{
+			return false;
+		}
+		
+		code = c;
+		streamPos++;
+	}
+	
+	streamPos++;
+	
+	while((c = streamPeek()) != '}')
+	{
+		if(c < 0 && !streamEnded)
+		{
+			return false;
+		}
+		
+		if(c < 0)
+		{
+			throw runtime_error("meta-data is missing a }");
+		}
+		
+		if(length < STREAMdescriptor)
+		{
+			descriptor[length] = c;
+		}
+		
+		length++;
+		streamPos++;
+	}
+	
+	streamPos++;
+	
+	while((c = streamPeek()) >= '0' && c <= '9')
+	{
+		val = (val*10) + (c - '0');
+		streamPos++;
+	}
+	
+	length = min(length, STREAMdescriptor);
+	return true;
+}
+
+/**
+@brief  the next buffered character of the stream without taking it
+@param  none
+@return  int character, -1 at the end of what has come in
+@pre  startStream()
+@post  none
+**/
+int streamPeek()
+{
+	if(streamPos >= streamLength)
+	{
+		return -1;
+	}
+	
+	return (unsigned char)streamBuffer[streamPos];
+}
+
+/**
+@brief  reads what has come in on the stream after the unread part of the buffer
+@param  bool block, wait for the writer rather than return when nothing has come in
+@return  bool true if more came in or the stream ended, false if nothing has come in yet
+@pre  startStream()
+@post  the buffer starts at the unread part, grown only when an application is longer than it
+**/
+bool streamFill(bool block) throw(runtime_error)
+{
+	if(streamEnded)
+	{
+		return false;
+	}
+	
+	//keep the unread part
+	if(streamPos > 0)
+	{
+		memmove(&streamBuffer[0], &streamBuffer[streamPos], streamLength - streamPos);
+		streamLength -= streamPos;
+		streamPos = 0;
+	}
+	
+	if(streamLength == (int)streamBuffer.size())
+	{
+		streamBuffer.resize(streamBuffer.size()*2);
+	}
+	
+	pollfd waiting;
+	waiting.fd = streamFd;
+	waiting.events = POLLIN;
+	waiting.revents = 0;
+	
+	while(true)
+	{
+		int ready = poll(&waiting, 1, block ? -1 : 0);
+		
+		if(ready < 0 && errno == EINTR)
+		{
+			continue;
+		}
+		
+		if(ready < 0)
+		{
+			throw runtime_error("meta-data stream could not be read");
+		}
+		
+		if(ready == 0)
+		{
+			return false;
+		}
+		
+		ssize_t count = read(streamFd, &streamBuffer[streamLength], streamBuffer.size() - streamLength);
+		
+		if(count < 0 && (errno == EINTR || errno == EAGAIN))
+		{
+			continue;
+		}
+		
+		//end of file, or the writer is gone
+		if(count <= 0)
+		{
+			streamEnded = true;
+			return true;
+		}
+		
+		parseBytes += count;
+		streamLength += count;
+		return true;
+	}
+}
+
+/**
+@brief  drops a finished streamed process, keeping only its metrics
+@param  int id
+@return  none
+@pre  the process has exited
+@post  its process and program slot are free for the next application
+**/
+void releaseProcess(int id)
+{
+	processData& tempProcess = processTable[id];
+	streamTurnaround += tempProcess.finish - tempProcess.arrival;
+	streamWaiting += tempProcess.waiting;
+	streamResponse += tempProcess.firstRun - tempProcess.arrival;
+	
+	if(streamMetrics.is_open())
+	{
+		metricsRow(streamMetrics, tempProcess);
+	}
+	
+	vector<int>().swap(tempProcess.memory);
+	tempProcess.pages.clear();
+	freeProcesses.push_back(id);
+	streamLive--;
+}
+
+/**
+@brief  runs the parsed processes with the devices and logger up
+@param  none
+@return  none
+@pre  readInput()
+@post  every process has run and the simulation output is written
+**/
+void runSimulation()
+{
+	startLogger(tempConfig.logFile);
+	startDevicePool();
+	startTrace(tempConfig.traceFile);
+	startOutput(tempConfig.logFile);
+	runScheduler();
+	endOutput(tempConfig.logFile);
+	stopTrace();
+	stopDevicePool();
+	stopLogger();
+}
+/**
+@brief  a function that outputs the start of a task as its processor or device starts it, formatted from its entry in the operation table
+@param  ioJob *tempJob
+@return  none
+@pre  startVirtualIO() or completeIO()
+@post  sends the start lines for the task to the logger, so the log stays in time order while jobs overlap
+**/
+void outputStart(ioJob* tempJob)
+{
+	const opDescriptor& tempOp = opTable[tempJob->op];
+	char logOut[LOGslotSize];
+	int length;
+	
+	//application start and finish are reported by the OS
+	if(tempJob->op == OPstart)
+	{
+		length = snprintf(logOut, sizeof(logOut), "%f - %s %d\n%f - %s %d\n", tempJob->startTime, tempOp.startText, tempJob->processCount, tempJob->startTime, tempOp.endText, tempJob->processCount);
+	}
+	
+	else if(tempJob->op == OPfinish)
+	{
+		length = snprintf(logOut, sizeof(logOut), "%f - %s %d\n", tempJob->startTime, tempOp.startText, tempJob->processCount);
+	}
+	
+	//hard drives and projectors name the device the task ran on
+	else if(tempOp.unitName[0] != '\0')
+	{
+		length = snprintf(logOut, sizeof(logOut), "%f - Process %d: %s on %s %d\n", tempJob->startTime, tempJob->processCount, tempOp.startText, tempOp.unitName, tempJob->unit);
+	}
+	
+	else
+	{
+		length = snprintf(logOut, sizeof(logOut), "%f - Process %d: %s\n", tempJob->startTime, tempJob->processCount, tempOp.startText);
+	}
+	
+	logWrite(logOut, length);
+}
+
+/**
+@brief  a function that outputs the end of one finished task, formatted from its entry in the operation table
+@param  string filename, int op, int tempCount, double tempStart, double tempEnd, int tempDevice
+@return  none
+@pre  timerProcess(), outputStart()
+@post  sends the end lines for the task to the logger, which prints to file, monitor or both
+**/
+void output(string filename, int op, int tempCount, double tempStart, double tempEnd, int tempDevice)
+{
+	double formatStart = wallTime();
+	const opDescriptor& tempOp = opTable[op];
+	char logOut[LOGslotSize];
+	int length = 0;
+	
+	//application start and finish are done in their start lines
+	if(op == OPstart || op == OPfinish)
+	{
+		length = 0;
+	}
+	
+	//memory allocation reports the block it handed out, passed in as the device
+	else if(op == OPallocate)
+	{
+		//an interrupted allocation has not been handed a block yet
+		if(isReset == false && tempDevice < 0)
+		{
+			length = snprintf(logOut, sizeof(logOut), "%f - Process %d: memory allocation failed\n", tempEnd, tempCount);
+		}
+		
+		else if(isReset == false)
+		{
+			length = snprintf(logOut, sizeof(logOut), "%f - Process %d: %s 0x%08x\n", tempEnd, tempCount, tempOp.endText, tempDevice);
+		}
+	}
+	
+	//hard drives and projectors name the device the task ran on
+	else if(tempOp.unitName[0] != '\0')
+	{
+		length = snprintf(logOut, sizeof(logOut), "%f - Process %d: %s on %s %d\n", tempEnd, tempCount, tempOp.endText, tempOp.unitName, tempDevice);
+	}
+	
+	else
+	{
+		length = snprintf(logOut, sizeof(logOut), "%f - Process %d: %s\n", tempEnd, tempCount, tempOp.endText);
+	}
+	
+	//if process was interrupted by PQN
+	if(isReset == true)
+	{
+		length += snprintf(logOut + length, sizeof(logOut) - length, "%f - ******* Process was interrupted *******\n", currentTime());
+	}
+	
+	formatTotal += wallTime() - formatStart;
+	formatCount++;
+	
+	if(length > 0)
+	{
+		logWrite(logOut, length);
+	}
+}
+//----------------------------------------------------------------------------------------------------
+//resource management system
+//----------------------------------------------------------------------------------------------------
+
+/**
+@brief  runs the ready processes on every processor, keeping them busy while input/output is in flight
+@param  none
+@return  none
+@pre  dispatchCore(), completeIO(), waitIO()
+@post  every process has run to its application finish, every streamed application has been read
+**/
+void runScheduler()
+{
+	while(true)
+	{
+		//handle the processor and input/output interrupts that came in
+		completeIO();
+		
+		//fill the stream window back up with the applications that have already come in
+		if(streamOpen)
+		{
+			streamAdmit(false);
+		}
+		
+		//give every idle processor a process, stealing if its own queue is empty
+		for(unsigned int i = 0; i < cores.size(); i++)
+		{
+			dispatchCore(i);
+		}
+		
+		//nothing is running and nothing is ready, only then wait on the stream writer
+		if(jobsInFlight == 0)
+		{
+			if(streamOpen && streamLive < streamWindow)
+			{
+				streamAdmit(true);
+				continue;
+			}
+			
+			break;
+		}
+		
+		//wait for the next interrupt
+		waitIO();
+	}
+}
+
+/**
+@brief  starts the next ready process on an idle processor
+@param  int core
+@return  none
+@pre  timerProcess()
+@post  the processor is running a command, or idle because no process is ready anywhere or an event is due first
+**/
+void dispatchCore(int core)
+{
+	while(cores[core].running < 0)
+	{
+		//on the virtual clock everything due now comes in first, so a process is not started only to be preempted at once
+		if(clockMode == CLOCKvirtual && eventDue())
+		{
+			return;
+		}
+		
+		int id = nextReady(core);
+		
+		if(id < 0)
+		{
+			return;
+		}
+		
+		//time the switch away from an interrupted process
+		if(cores[core].switchStart >= 0.0)
+		{
+			quantumOverhead += wallTime() - cores[core].switchStart;
+			cores[core].switchStart = -1.0;
+		}
+		
+		setState(id, PCBstart);
+		cores[core].running = id;
+		cores[core].quantum = tempConfig.pqn;
+		processTable[id].core = core;
+		timerProcess(core);
+	}
+}
+
+/**
+@brief  takes the next process from a processor's own queue, or steals from the longest queue
+@param  int core
+@return  int id, -1 if no process is ready
+@pre  readyProcess()
+@post  a stolen process moves to this processor
+**/
+int nextReady(int core)
+{
+	if(queueLength(core) > 0)
+	{
+		return (strs == true) ? strPop(core) : rrPop(core);
+	}
+	
+	//work stealing
+	int victim = -1;
+	
+	for(unsigned int i = 0; i < cores.size(); i++)
+	{
+		if(queueLength(i) > 0 && (victim < 0 || queueLength(i) > queueLength(victim)))
+		{
+			victim = i;
+		}
+	}
+	
+	if(victim < 0)
+	{
+		return -1;
+	}
+	
+	cores[core].steals++;
+	return (strs == true) ? strPop(victim) : rrPop(victim);
+}
+
+/**
+@brief  number of processes waiting on a processor's run queue
+@param  int core
+@return  int
+@pre  none
+@post  none
+**/
+int queueLength(int core)
+{
+	if(strs == true)
+	{
+		return cores[core].strHeap.size();
+	}
+	
+	return cores[core].rrSize;
+}
+
+/**
+@brief  a function that starts the running process's next command on its processor, handling the quantum and preemption
+@param  int core
+@return  none
+@pre  simulateProcess(), loadProcess()
+@post  sets the PCB, the command is in flight on the processor or a device, or the process went back to a ready queue
+**/
+void timerProcess(int core)
+{	
+	processData& tempProcess = processTable[cores[core].running];
+	int tempOp = tempProcess.program->commands[tempProcess.pc].op;
+	
+	//copy process information
+	totalTime = tempProcess.remaining;
+	checkTime += totalTime;
+	
+	//100ms check
+	if(checkTime > 100)
+	{
+		loadProcess();
+		checkTime = 0;
+	}
+	
+	//shortest time remaining, a shorter ready process takes the processor, including one just loaded
+	if(strs == true && !cores[core].strHeap.empty() && strLess(cores[core].strHeap[0], tempProcess.id))
+	{
+		char logOut[LOGslotSize];
+		int length = snprintf(logOut, sizeof(logOut), "%f - ******* Process %d was preempted by process %d *******\n", currentTime(), tempProcess.processCount, processTable[cores[core].strHeap[0]].processCount);
+		logWrite(logOut, length);
+		cores[core].running = -1;
+		preemptCount++;
+		readyProcess(tempProcess.id);
+		return;
+	}
+	
+	setState(tempProcess.id, PCBrunning);
+	
+	//input/output gives up the processor until its interrupt
+	if(opTable[tempOp].device >= 0)
+	{
+		setState(tempProcess.id, PCBwaiting);
+		cores[core].running = -1;
+		simulateProcess(tempProcess, core, false);
+		return;
+	}
+	
+	//round robin scheduling
+	if(rrs == true)
+	{
+		//quantum ran out exactly at the end of the last command
+		if(cores[core].quantum <= 0)
+		{
+			char logOut[LOGslotSize];
+			int length = snprintf(logOut, sizeof(logOut), "%f - ******* Process was interrupted *******\n", currentTime());
+			logWrite(logOut, length);
+			interruptProcess(core);
+			return;
+		}
+		
+		//only run what is left of the quantum
+		if(totalTime > cores[core].quantum)
+		{
+			totalTime = cores[core].quantum;
+			cores[core].quantum = 0;
+			simulateProcess(tempProcess, core, true);
+			return;
+		}
+		
+		cores[core].quantum -= totalTime;
+	}
+	
+	//run the whole command
+	simulateProcess(tempProcess, core, false);
+}
+
+/**
+@brief  takes the running process off a processor at the end of its quantum
+@param  int core
+@return  none
+@pre  timerProcess()
+@post  the process is at the back of the ready queue and the processor is idle
+**/
+void interruptProcess(int core)
+{
+	int id = cores[core].running;
+	cores[core].switchStart = wallTime();
+	cores[core].running = -1;
+	quantumCount++;
+	readyProcess(id);
+}
+
+/**
+@brief  function that simulates totalTime msec of the process's current command on its processor or a device
+@param  processData &tempProcess, int core, bool interrupted
+@return  none
+@pre  submitIO()
+@post  the job comes back through completeIO(), input/output goes to a device with the process id
+**/
+void simulateProcess(processData& tempProcess, int core, bool interrupted)
+{
+	int op = tempProcess.program->commands[tempProcess.pc].op;
+	ioJob* tempJob = new ioJob;
+	tempJob->process = tempProcess.id;
+	tempJob->processCount = tempProcess.processCount;
+	tempJob->op = op;
+	tempJob->duration = totalTime;
+	tempJob->interrupted = interrupted;
+	tempJob->preemptedBy = -1;
+	tempJob->cut = false;
+	tempJob->event = -1;
+	tempJob->startTime = -1.0;
+	tempJob->endTime = -1.0;
+	
+	//if input/output, hand the cycle to a device
+	if(opTable[op].device >= 0)
+	{
+		tempJob->device = opTable[op].device;
+		tempJob->unit = deviceUnit(tempJob->device, totalTime);
+		
+		//spread hard drive requests over the cylinders, the same way on every run
+		if(tempJob->device == DEVICEhdd)
+		{
+			tempJob->cylinder = (int)(((unsigned long)tempProcess.processCount*7919 + (unsigned long)tempProcess.pc*104729) % diskCylinders);
+		}
+	}
+
+	//else, run it on the processor
+	else
+	{
+		tempJob->device = DEVICEcpu;
+		tempJob->unit = core;
+		cores[core].job = tempJob;
+	}
+	
+	submitIO(tempJob);
+}
+
+/**
+@brief  a function that adds processes to the end of STR or RR queue
+@param  none
+@return  none
+@pre  none
+@post  every 100 ms, a new process for each program will be added, up to 10 times, sharing the program's commands
+**/
+void loadProcess()
+{
+	//streamed applications are released when they finish, there is nothing to copy
+	if (totalCount < 9 && metaStream == 0)
+	{
+		//delay(100);
+		for(unsigned int i = 0; i < masterPrograms.size(); i++)
+		{	
+			readyProcess(newProcess(masterPrograms[i]));
+		}
+		
+		totalCount++;
+	}
+}
+
+/**
+@brief  makes a process that runs a program from its first command
+@param  const programData *tempProgram
+@return  int id in processTable
+@pre  readInput()
+@post  the process gets the next process number, the program is shared not copied, a released slot is used first
+**/
+int newProcess(const programData* tempProgram)
+{
+	processData tempProcess;
+	tempProcess.id = processTable.size();
+	tempProcess.program = tempProgram;
+	tempProcess.pc = 0;
+	tempProcess.remaining = tempProgram->commands[0].cycleTime;
+	tempProcess.processCount = ++processID;
+	tempProcess.next = -1;
+	tempProcess.core = -1;
+	tempProcess.state = -1;
+	tempProcess.arrival = -1.0;
+	tempProcess.firstRun = -1.0;
+	tempProcess.finish = -1.0;
+	tempProcess.readySince = -1.0;
+	tempProcess.waiting = 0.0;
+	tempProcess.traced = false;
+	
+	//a released slot, streaming only
+	if(!freeProcesses.empty())
+	{
+		tempProcess.id = freeProcesses.back();
+		freeProcesses.pop_back();
+		processTable[tempProcess.id] = tempProcess;
+		return tempProcess.id;
+	}
+	
+	processTable.push_back(tempProcess);
+	return tempProcess.id;
+}
+
+/**
+@brief  puts a process on a processor's ready queue, the one it last ran on or else the least loaded
+@param  int id
+@return  none
+@pre  newProcess()
+@post  the process is in that processor's STR heap or at the back of its RR queue
+**/
+void readyProcess(int id)
+{
+	int core = processTable[id].core;
+	setState(id, PCBready);
+	
+	//new processes go to the processor with the least work
+	if(core < 0)
+	{
+		core = 0;
+		
+		for(unsigned int i = 1; i < cores.size(); i++)
+		{
+			if(queueLength(i) + (cores[i].running >= 0) < queueLength(core) + (cores[core].running >= 0))
+			{
+				core = i;
+			}
+		}
+		
+		processTable[id].core = core;
+	}
+	
+	if(strs == true)
+	{
+		strPush(core, id);
+		strPreempt(core);
+	}
+	
+	else
+	{
+		rrPush(core, id);
+	}
+}
+
+/**
+@brief  cuts the processor command in flight short when a shorter process was just readied on its processor
+@param  int core
+@return  none
+@pre  readyProcess()
+@post  the command ends now on the virtual clock, or at the worker's next millisecond on the real clocks, with what it ran so far, and completeIO() puts its process back in the STR heap
+**/
+void strPreempt(int core)
+{
+	ioJob* tempJob = cores[core].job;
+	
+	if(tempJob == NULL || tempJob->interrupted)
+	{
+		return;
+	}
+	
+	//on the real clocks the worker times the command, so it is only read under the interrupt lock once it has started and before it ends
+	pthread_mutex_lock(&jobMtx);
+	bool running = clockMode == CLOCKvirtual || (tempJob->startTime >= 0.0 && tempJob->endTime < 0.0);
+	int elapsed = (int)((currentTime() - tempJob->startTime)*1000.0 + 0.5);
+	int shortest = cores[core].strHeap[0];
+	
+	//the running process would still need less than the new one
+	if(!running || elapsed >= tempJob->duration || timeRemaining(processTable[shortest]) >= timeRemaining(processTable[tempJob->process]) - elapsed)
+	{
+		pthread_mutex_unlock(&jobMtx);
+		return;
+	}
+	
+	tempJob->interrupted = true;
+	tempJob->preemptedBy = shortest;
+	tempJob->cut = true;
+	pthread_mutex_unlock(&jobMtx);
+	
+	//the worker sets how long it ran when it stops
+	if(clockMode != CLOCKvirtual)
+	{
+		return;
+	}
+	
+	cancelledEvents.insert(tempJob->event);
+	devicePool[DEVICEcpu][core]->busyTime -= (tempJob->duration - elapsed)/1000.0;
+	tempJob->duration = elapsed;
+	scheduleEvent(simClock, EVENTdone, tempJob);
+}
+
+/**
+@brief  adds a process to the back of a processor's RR run queue
+@param  int core, int id
+@return  none
+@pre  newProcess()
+@post  O(1), the process keeps its pc and what is left of an interrupted command
+**/
+void rrPush(int core, int id)
+{
+	processTable[id].next = -1;
+	
+	if(cores[core].rrTail >= 0)
+	{
+		processTable[cores[core].rrTail].next = id;
+	}
+	
+	else
+	{
+		cores[core].rrHead = id;
+	}
+	
+	cores[core].rrTail = id;
+	cores[core].rrSize++;
+}
+
+/**
+@brief  takes the process at the front of a processor's RR run queue
+@param  int core
+@return  int id
+@pre  the queue is not empty
+@post  O(1)
+**/
+int rrPop(int core)
+{
+	int id = cores[core].rrHead;
+	cores[core].rrHead = processTable[id].next;
+	
+	if(cores[core].rrHead < 0)
+	{
+		cores[core].rrTail = -1;
+	}
+	
+	processTable[id].next = -1;
+	cores[core].rrSize--;
+	return id;
+}
+
+/**
+@brief  msec a process still needs, counting what is left of its current command
+@param  const processData &tempProcess
+@return  int milliseconds
+@pre  newProcess()
+@post  none
+**/
+int timeRemaining(const processData& tempProcess)
+{
+	if(processDone(tempProcess))
+	{
+		return 0;
+	}
+	
+	return (tempProcess.remaining + tempProcess.program->timeLeft[tempProcess.pc + 1]);
+}
+
+/**
+@brief  moves a process on to its next command
+@param  processData &tempProcess
+@return  none
+@pre  newProcess()
+@post  remaining is the full cycle time of the new command
+**/
+void nextCommand(processData& tempProcess)
+{
+	tempProcess.pc++;
+	
+	if(!processDone(tempProcess))
+	{
+		tempProcess.remaining = tempProcess.program->commands[tempProcess.pc].cycleTime;
+	}
+}
+
+/**
+@brief  checks if a process has run all of its program
+@param  const processData &tempProcess
+@return  bool
+@pre  newProcess()
+@post  none
+**/
+bool processDone(const processData& tempProcess)
+{
+	return (tempProcess.pc >= (int)tempProcess.program->commands.size());
+}
+
+/**
+@brief  a long lived worker that runs the cycles queued on one processor or device
+@param  void *device
+@return  none
+@pre  startDevicePool(), runCycle()
+@post  every job taken off the device queue gets its start and end time and is passed back as an interrupt
+**/
+void* ioProcess(void *device)
+{
+	deviceQueue* tempDevice = (deviceQueue*)device;
+	
+	while(true)
+	{
+		//wait for work or shutdown
+		pthread_mutex_lock(&tempDevice->lock);
+		
+		while(tempDevice->jobs.empty() && tempDevice->cylinders.empty() && poolRunning)
+		{
+			pthread_cond_wait(&tempDevice->ready, &tempDevice->lock);
+		}
+		
+		if(tempDevice->jobs.empty() && tempDevice->cylinders.empty())
+		{
+			pthread_mutex_unlock(&tempDevice->lock);
+			break;
+		}
+		
+		ioJob* tempJob = nextJob(tempDevice);
+		pthread_mutex_unlock(&tempDevice->lock);
+		
+		//time spent queued behind a busy device is not dispatch latency
+		if(tempJob->submitted > tempDevice->lastDone)
+		{
+			tempJob->dispatchLatency = wallTime() - tempJob->submitted;
+		}
+		
+		else
+		{
+			tempJob->dispatchLatency = wallTime() - tempDevice->lastDone;
+		}
+		
+		//simulate the cycle, only this device is held so other devices overlap
+		int ran = runCycle(tempJob);
+		tempDevice->lastDone = wallTime();
+		tempDevice->served++;
+		
+		//interrupt the scheduler, timed under the same lock as the start so the log is in time order
+		pthread_mutex_lock(&jobMtx);
+		tempJob->endTime = currentTime();
+		
+		//a preemption that came in after the last millisecond had run cuts nothing
+		if(tempJob->cut && ran >= tempJob->duration)
+		{
+			tempJob->interrupted = false;
+			tempJob->preemptedBy = -1;
+		}
+		
+		tempJob->duration = ran;
+		tempDevice->waitTotal += tempJob->startTime - tempJob->queued;
+		tempDevice->busyTime += tempJob->endTime - tempJob->startTime;
+		completedJobs.push(make_pair(tempJob, false));
+		pthread_cond_signal(&jobDone);
+		pthread_mutex_unlock(&jobMtx);
+	}
+	
+  	pthread_exit(0);
+}
+
+/**
+@brief  creates the configured processors, each idle with an empty run queue
+@param  none
+@return  none
+@pre  readConfig()
+@post  processes can be readied on any of the processors
+**/
+void startCores()
+{
+	int units = 1;
+	
+	if(tempConfig.numCores > 1)
+	{
+		units = tempConfig.numCores;
+	}
+	
+	coreData tempCore;
+	tempCore.running = -1;
+	tempCore.quantum = 0;
+	tempCore.rrHead = -1;
+	tempCore.rrTail = -1;
+	tempCore.rrSize = 0;
+	tempCore.busyTime = 0.0;
+	tempCore.commands = 0;
+	tempCore.steals = 0;
+	tempCore.switchStart = -1.0;
+	tempCore.job = NULL;
+	cores.assign(units, tempCore);
+}
+
+/**
+@brief  creates every configured device, with one worker thread each unless the clock is virtual
+@param  none
+@return  none
+@pre  readConfig()
+@post  the device queues accept jobs until stopDevicePool()
+**/
+void startDevicePool()
+{
+	pthread_mutex_init(&jobMtx, NULL);
+	pthread_cond_init(&jobDone, NULL);
+	poolRunning = true;
+	
+	for(int i = 0; i < NUMdevices; i++)
+	{
+		int units = 1;
+		
+		if(i == DEVICEhdd && tempConfig.numHDD > 1)
+		{
+			units = tempConfig.numHDD;
+		}
+		
+		else if(i == DEVICEprojector && tempConfig.numProj > 1)
+		{
+			units = tempConfig.numProj;
+		}
+		
+		else if(i == DEVICEcpu)
+		{
+			units = cores.size();
+		}
+		
+		for(int j = 0; j < units; j++)
+		{
+			deviceQueue* tempDevice = new deviceQueue;
+			tempDevice->device = i;
+			tempDevice->busy = false;
+			tempDevice->lastDone = 0.0;
+			tempDevice->head = 0;
+			tempDevice->direction = 1;
+			tempDevice->served = 0;
+			tempDevice->seekTotal = 0;
+			tempDevice->waitTotal = 0.0;
+			tempDevice->busyTime = 0.0;
+			tempDevice->available = 0.0;
+			pthread_mutex_init(&tempDevice->lock, NULL);
+			pthread_cond_init(&tempDevice->ready, NULL);
+			
+			if(clockMode != CLOCKvirtual)
+			{
+				pthread_create(&tempDevice->worker, NULL, &ioProcess, tempDevice);
+			}
+			
+			devicePool[i].push_back(tempDevice);
+			
+			//all idle, so unit order is already a heap
+			deviceHeap[i].push_back(j);
+		}
+	}
+}
+
+/**
+@brief  drains and joins the device workers
+@param  none
+@return  none
+@pre  startDevicePool()
+@post  all worker threads have exited and the devices are freed
+**/
+void stopDevicePool()
+{
+	for(int i = 0; i < NUMdevices; i++)
+	{
+		for(unsigned int j = 0; j < devicePool[i].size(); j++)
+		{
+			pthread_mutex_lock(&devicePool[i][j]->lock);
+			poolRunning = false;
+			pthread_cond_signal(&devicePool[i][j]->ready);
+			pthread_mutex_unlock(&devicePool[i][j]->lock);
+		}
+	}
+	
+	for(int i = 0; i < NUMdevices; i++)
+	{
+		for(unsigned int j = 0; j < devicePool[i].size(); j++)
+		{
+			if(clockMode != CLOCKvirtual)
+			{
+				pthread_join(devicePool[i][j]->worker, NULL);
+			}
+			
+			pthread_mutex_destroy(&devicePool[i][j]->lock);
+			pthread_cond_destroy(&devicePool[i][j]->ready);
+			delete devicePool[i][j];
+		}
+		
+		devicePool[i].clear();
+		deviceHeap[i].clear();
+	}
+	
+	pthread_mutex_destroy(&jobMtx);
+	pthread_cond_destroy(&jobDone);
+}
+
+/**
+@brief  queues an input/output job on its device without waiting for it
+@param  ioJob *tempJob
+@return  none
+@pre  startDevicePool()
+@post  the job comes back through completeIO() once the device has run it
+**/
+void submitIO(ioJob* tempJob)
+{
+	deviceQueue* tempDevice = devicePool[tempJob->device][tempJob->unit];
+	tempJob->submitted = wallTime();
+	tempJob->queued = currentTime();
+	tempJob->dispatchLatency = 0.0;
+	jobsInFlight++;
+	
+	//on the virtual clock the device starts now if idle, otherwise the job waits its turn
+	if(clockMode == CLOCKvirtual)
+	{
+		queueJob(tempDevice, tempJob);
+		
+		if(!tempDevice->busy)
+		{
+			ioJob* nextStart = nextJob(tempDevice);
+			startVirtualIO(tempDevice, nextStart);
+			outputStart(nextStart);
+		}
+		
+		return;
+	}
+	
+	pthread_mutex_lock(&tempDevice->lock);
+	queueJob(tempDevice, tempJob);
+	pthread_cond_signal(&tempDevice->ready);
+	pthread_mutex_unlock(&tempDevice->lock);
+}
+
+/**
+@brief  starts a job on an idle device on the virtual clock
+@param  deviceQueue *tempDevice, ioJob *tempJob
+@return  none
+@pre  scheduleEvent()
+@post  the device is busy until the job's event fires, the caller logs the job's start line
+**/
+void startVirtualIO(deviceQueue* tempDevice, ioJob* tempJob)
+{
+	tempDevice->busy = true;
+	tempJob->startTime = simClock;
+	tempDevice->served++;
+	tempDevice->waitTotal += simClock - tempJob->queued;
+	tempDevice->busyTime += tempJob->duration/1000.0;
+	scheduleEvent(simClock + (tempJob->duration/1000.0), EVENTdone, tempJob);
+}
+
+/**
+@brief  adds a job to a device queue, by cylinder on a hard drive with a disk scheduling policy
+@param  deviceQueue *tempDevice, ioJob *tempJob
+@return  none
+@pre  the device queue is locked by the caller
+@post  nextJob() can take the job
+**/
+void queueJob(deviceQueue* tempDevice, ioJob* tempJob)
+{
+	if(tempDevice->device == DEVICEhdd && diskPolicy != DISKfcfs)
+	{
+		tempDevice->cylinders.insert(make_pair(tempJob->cylinder, tempJob));
+	}
+	
+	else
+	{
+		tempDevice->jobs.push_back(tempJob);
+	}
+}
+
+/**
+@brief  takes the next job off a device queue, in arrival order except on hard drives, which use the disk scheduling policy
+@param  deviceQueue *tempDevice
+@return  ioJob* the job to run next
+@pre  the device queue is not empty and is locked by the caller
+@post  the job is off the queue, a hard drive's arm has moved to its cylinder
+**/
+ioJob* nextJob(deviceQueue* tempDevice)
+{
+	ioJob* tempJob;
+	
+	if(!tempDevice->cylinders.empty())
+	{
+		multimap<int, ioJob*>& pending = tempDevice->cylinders;
+		int head = tempDevice->head;
+		
+		//first request at or past the arm, requests on one cylinder stay in arrival order
+		multimap<int, ioJob*>::iterator pick = pending.lower_bound(head);
+		multimap<int, ioJob*>::iterator below = pick;
+		
+		if(below != pending.begin())
+		{
+			below = pending.lower_bound(prev(below)->first);
+		}
+		
+		else
+		{
+			below = pending.end();
+		}
+		
+		//closest cylinder either way
+		if(diskPolicy == DISKsstf)
+		{
+			if(pick == pending.end() || (below != pending.end() && head - below->first < pick->first - head))
+			{
+				pick = below;
+			}
+		}
+		
+		//keep sweeping the same way, turning round at the edge of the disk once no request is left ahead
+		else if(diskPolicy == DISKscan)
+		{
+			bool onHead = pick != pending.end() && pick->first == head;
+			
+			if((tempDevice->direction < 0 && below != pending.end() && !onHead) || pick == pending.end())
+			{
+				pick = below;
+			}
+		}
+		
+		//sweep up only, jumping back to the lowest request
+		else if(pick == pending.end())
+		{
+			pick = pending.begin();
+		}
+		
+		tempJob = pick->second;
+		pending.erase(pick);
+	}
+	
+	else
+	{
+		tempJob = tempDevice->jobs.front();
+		tempDevice->jobs.pop_front();
+	}
+	
+	//move the arm
+	if(tempDevice->device == DEVICEhdd)
+	{
+		int seek = abs(tempJob->cylinder - tempDevice->head);
+		
+		if(tempJob->cylinder != tempDevice->head)
+		{
+			int direction = (tempJob->cylinder > tempDevice->head) ? 1 : -1;
+			
+			//scan runs on to the edge of the disk before it turns round
+			if(diskPolicy == DISKscan && direction != tempDevice->direction)
+			{
+				int edge = (tempDevice->direction > 0) ? diskCylinders - 1 : 0;
+				seek = abs(edge - tempDevice->head) + abs(edge - tempJob->cylinder);
+			}
+			
+			tempDevice->direction = direction;
+		}
+		
+		tempDevice->seekTotal += seek;
+		tempDevice->head = tempJob->cylinder;
+	}
+	
+	return tempJob;
+}
+
+/**
+@brief  handles every processor and input/output interrupt that has come in
+@param  none
+@return  none
+@pre  submitIO()
+@post  started jobs have their start lines logged, finished jobs their end lines, a process that finished a command on a processor carries on there, one back from input/output is ready again
+**/
+void completeIO()
+{
+	while(true)
+	{
+		pthread_mutex_lock(&jobMtx);
+		
+		if(completedJobs.empty())
+		{
+			pthread_mutex_unlock(&jobMtx);
+			break;
+		}
+		
+		ioJob* tempJob = completedJobs.front().first;
+		bool started = completedJobs.front().second;
+		completedJobs.pop();
+		pthread_mutex_unlock(&jobMtx);
+		
+		//a worker has only started the job
+		if(started)
+		{
+			outputStart(tempJob);
+			continue;
+		}
+		
+		processData& tempProcess = processTable[tempJob->process];
+		jobsInFlight--;
+		
+		//processor command
+		if(tempJob->device == DEVICEcpu)
+		{
+			int core = tempJob->unit;
+			cores[core].busyTime += tempJob->endTime - tempJob->startTime;
+			cores[core].commands++;
+			cores[core].job = NULL;
+			isReset = tempJob->interrupted;
+			int address = 0;
+			
+			//memory is handed out once the whole command has run
+			if(tempJob->op == OPallocate && !tempJob->interrupted)
+			{
+				address = memoryAllocate(tempJob->process, tempMemory.blockSize);
+			}
+			
+			//the page is where the command sits in its program, its cycles are only how long it takes
+			else if(tempJob->op == OPblock && !tempJob->interrupted && pagingPolicy != PAGINGoff)
+			{
+				pageAccess(tempJob->process, tempProcess.pc % processPages);
+			}
+			
+			output(tempConfig.logFile, tempJob->op, tempProcess.processCount, tempJob->startTime, tempJob->endTime, address);
+			traceOperation(tempJob);
+			
+			//a shorter process took the processor part way through the command
+			if(tempJob->preemptedBy >= 0)
+			{
+				char logOut[LOGslotSize];
+				int length = snprintf(logOut, sizeof(logOut), "%f - ******* Process %d was preempted by process %d *******\n", currentTime(), tempProcess.processCount, processTable[tempJob->preemptedBy].processCount);
+				logWrite(logOut, length);
+				tempProcess.remaining -= tempJob->duration;
+				cores[core].running = -1;
+				preemptCount++;
+				readyProcess(tempJob->process);
+			}
+			
+			//round robin quantum ran out part way through the command
+			else if(tempJob->interrupted)
+			{
+				tempProcess.remaining -= tempJob->duration;
+				interruptProcess(core);
+			}
+			
+			else
+			{
+				nextCommand(tempProcess);
+				
+				if(processDone(tempProcess))
+				{
+					memoryRelease(tempProcess);
+					pageRelease(tempProcess);
+					setState(tempJob->process, PCBexit);
+					cores[core].running = -1;
+					finishedCount++;
+					
+					if(metaStream == 1)
+					{
+						releaseProcess(tempJob->process);
+					}
+				}
+				
+				else
+				{
+					timerProcess(core);
+				}
+			}
+		}
+		
+		//input/output command, never cut by the quantum
+		else
+		{
+			if(clockMode != CLOCKvirtual)
+			{
+				dispatchCount++;
+				dispatchTotal += tempJob->dispatchLatency;
+			}
+			
+			isReset = false;
+			output(tempConfig.logFile, tempJob->op, tempProcess.processCount, tempJob->startTime, tempJob->endTime, tempJob->unit);
+			traceOperation(tempJob);
+			nextCommand(tempProcess);
+			
+			//back to the ready queue
+			readyProcess(tempJob->process);
+		}
+		
+		delete tempJob;
+	}
+}
+
+/**
+@brief  blocks until a processor or input/output interrupt comes in
+@param  none
+@return  none
+@pre  submitIO()
+@post  at least one finished job is waiting for completeIO()
+**/
+void waitIO()
+{
+	//on the virtual clock, jump to the next event
+	if(clockMode == CLOCKvirtual)
+	{
+		advanceClock();
+		return;
+	}
+	
+	pthread_mutex_lock(&jobMtx);
+	
+	while(completedJobs.empty())
+	{
+		pthread_cond_wait(&jobDone, &jobMtx);
+	}
+	
+	pthread_mutex_unlock(&jobMtx);
+}
+
+/**
+@brief  looks up a meta-data code and descriptor in the operation table
+@param  char code, const char *descriptor, int length
+@return  int op, -1 if it is not an operation
+@pre  none
+@post  none
+**/
+int findOp(char code, const char* descriptor, int length)
+{
+	for(int i = 0; i < NUMops; i++)
+	{
+		if(opTable[i].code == code && strncmp(opTable[i].descriptor, descriptor, length) == 0 && opTable[i].descriptor[length] == '\0')
+		{
+			return i;
+		}
+	}
+	
+	return -1;
+}
+
+/**
+@brief  the cycle time of an operation from the config
+@param  int op, int cycles
+@return  int milliseconds
+@pre  readConfig()
+@post  none
+**/
+int opCycleTime(int op, int cycles)
+{
+	if(opTable[op].cycleTime == NULL)
+	{
+		return 1;
+	}
+	
+	return (cycles*(tempConfig.*opTable[op].cycleTime));
+}
+
+/**
+@brief  picks the unit of a device that frees up first, so work spreads by load rather than by turns
+@param  int device, int duration
+@return  int unit
+@pre  startDevicePool()
+@post  the unit is booked for duration msec past when it would have been free
+**/
+int deviceUnit(int device, int duration)
+{
+	int unit = deviceHeap[device][0];
+	deviceQueue* tempDevice = devicePool[device][unit];
+	tempDevice->available = max(tempDevice->available, currentTime()) + (duration/1000.0);
+	deviceSiftDown(device, 0);
+	return unit;
+}
+
+/**
+@brief  device heap order, earliest availability first, then the lower unit
+@param  int device, int unit1, int unit2
+@return  bool true if unit1 comes first
+@pre  none
+@post  none
+**/
+bool deviceLess(int device, int unit1, int unit2)
+{
+	double available1 = devicePool[device][unit1]->available;
+	double available2 = devicePool[device][unit2]->available;
+	
+	if(available1 != available2)
+	{
+		return available1 < available2;
+	}
+	
+	return unit1 < unit2;
+}
+
+/**
+@brief  moves a unit down the device heap after it has been booked
+@param  int device, int position
+@return  none
+@pre  deviceUnit()
+@post  the heap is ordered again
+**/
+void deviceSiftDown(int device, int position)
+{
+	vector<int>& heap = deviceHeap[device];
+	int unit = heap[position];
+	int size = heap.size();
+	
+	while(true)
+	{
+		int child = 2*position + 1;
+		
+		if(child >= size)
+		{
+			break;
+		}
+		
+		if(child + 1 < size && deviceLess(device, heap[child + 1], heap[child]))
+		{
+			child++;
+		}
+		
+		if(!deviceLess(device, heap[child], unit))
+		{
+			break;
+		}
+		
+		heap[position] = heap[child];
+		position = child;
+	}
+	
+	heap[position] = unit;
+}
+
+/**
+@brief  monotonic wall clock used for measuring the simulator itself
+@param  none
+@return  double seconds
+@pre  none
+@post  none
+**/
+double wallTime()
+{
+	timespec tempTime;
+	clock_gettime(CLOCK_MONOTONIC, &tempTime);
+	return tempTime.tv_sec + (tempTime.tv_nsec/1000000000.0);
+}
+
+/**
+@brief  a function that starts one job and waits out its cycles on the configured clock, for the processor and device workers
+@param  ioJob *tempJob
+@return  int milliseconds it ran, fewer than its duration if strPreempt() cut it short
+@pre  delay()
+@post  sets the job's startTime and tells the scheduler it started, the worker times the end
+**/
+int runCycle(ioJob* tempJob)
+{
+	//process time start, timed under the interrupt lock so the scheduler logs it in time order
+	pthread_mutex_lock(&jobMtx);
+	tempJob->startTime = currentTime();
+	completedJobs.push(make_pair(tempJob, true));
+	pthread_cond_signal(&jobDone);
+	pthread_mutex_unlock(&jobMtx);
+	
+	//shortest time remaining runs processor commands a millisecond at a time, so a shorter process can cut in
+	if(strs == true && tempJob->device == DEVICEcpu)
+	{
+		int ran = 0;
+		
+		while(ran < tempJob->duration && !tempJob->cut)
+		{
+			ran++;
+			delay(tempJob->startTime, ran);
+		}
+		
+		return ran;
+	}
+	
+	//simulate delay, to a deadline from the start so time spent getting here is not added on
+ 	delay(tempJob->startTime, tempJob->duration);
+	return tempJob->duration;
+}
+
+/**
+@brief  adds an event to the discrete event queue
+@param  double time, int type, ioJob *tempJob
+@return  none
+@pre  none
+@post  the event fires when advanceClock() reaches it
+**/
+void scheduleEvent(double time, int type, ioJob* tempJob)
+{
+	simEvent tempEvent;
+	tempEvent.time = time;
+	tempEvent.sequence = eventSequence++;
+	tempEvent.type = type;
+	tempEvent.job = tempJob;
+	eventQueue.push(tempEvent);
+	
+	if(tempJob != NULL)
+	{
+		tempJob->event = tempEvent.sequence;
+	}
+}
+
+/**
+@brief  moves the virtual clock forward to the earliest pending event
+@param  none
+@return  int type of the event that fired, -1 if there was none
+@pre  scheduleEvent()
+@post  the earliest event is removed and simClock is set to its time, a device event frees its device and raises an interrupt
+**/
+int advanceClock()
+{
+	if(eventQueue.empty())
+	{
+		return -1;
+	}
+	
+	simEvent tempEvent = eventQueue.top();
+	eventQueue.pop();
+	
+	//the command was cut short and already has an earlier event
+	if(cancelledEvents.erase(tempEvent.sequence) > 0)
+	{
+		return tempEvent.type;
+	}
+	
+	simClock = tempEvent.time;
+	
+	if(tempEvent.type == EVENTdone)
+	{
+		ioJob* tempJob = tempEvent.job;
+		deviceQueue* tempDevice = devicePool[tempJob->device][tempJob->unit];
+		tempJob->endTime = simClock;
+		completedJobs.push(make_pair(tempJob, false));
+		tempDevice->busy = false;
+		
+		//start the next job waiting on this device, its start is logged after this job's end
+		if(!tempDevice->jobs.empty() || !tempDevice->cylinders.empty())
+		{
+			ioJob* nextStart = nextJob(tempDevice);
+			startVirtualIO(tempDevice, nextStart);
+			completedJobs.push(make_pair(nextStart, true));
+		}
+	}
+	
+	return tempEvent.type;
+}
+
+/**
+@brief  checks for an event at the current virtual time
+@param  none
+@return  bool true if an event fires now
+@pre  scheduleEvent()
+@post  cancelled events at the front of the queue are dropped
+**/
+bool eventDue()
+{
+	while(!eventQueue.empty() && cancelledEvents.erase(eventQueue.top().sequence) > 0)
+	{
+		eventQueue.pop();
+	}
+	
+	return (!eventQueue.empty() && eventQueue.top().time <= simClock);
+}
+
+/**
+@brief  the current simulation time in seconds
+@param  none
+@return  double seconds
+@pre  none
+@post  reads the virtual clock, the steady wall clock or the processor clock depending on clockMode
+**/
+double currentTime()
+{
+	if(clockMode == CLOCKvirtual)
+	{
+		return simClock;
+	}
+	
+	//wall time is right however many threads are running or sleeping
+	if(clockMode == CLOCKreal)
+	{
+		return chrono::duration<double>(chrono::steady_clock::now() - realStart).count();
+	}
+	
+	return (clock()-timerStart)/(double)(CLOCKS_PER_SEC);
+}
+
+/**
+@brief  a function that simulates a delay based on the process time
+@param  double startTime, int milliseconds
+@return  none
+@pre  startTime was read from currentTime()
+@post  returns once the clock reaches startTime plus milliseconds, at once if it already has
+**/
+void delay(double startTime, int milliseconds)
+{
+	//sleep rather than spin, leaving the processor to the other threads
+	if(clockMode == CLOCKreal)
+	{
+		this_thread::sleep_until(realStart + chrono::duration_cast<chrono::steady_clock::duration>(chrono::duration<double>(startTime)) + chrono::milliseconds(milliseconds));
+		return;
+	}
+	
+	clock_t deadline = timerStart + (clock_t)(startTime*CLOCKS_PER_SEC) + milliseconds * (CLOCKS_PER_SEC/1000);
+	clock_t omega = clock();
+	
+	while (omega < deadline)
+	{
+			omega = clock();
+	}
+}
+
+/**
+@brief  runs an output print for the start of a simulation
+@param  string filename
+@return  none
+@pre  none
+@post  prints the start time for a program simulation
+**/
+void startOutput(string filename)
+{
+	stringstream logOut;
+	logOut << fixed << currentTime() << " - Simulator program starting" << '\n';
+	logWrite(logOut.str());
+}
+
+/**
+@brief  runs an output print for the end of a simulation
+@param  string filename
+@return  none
+@pre  none
+@post  prints the end time for a program simulation
+**/
+void endOutput(string filename)
+{
+	double clockEnd = currentTime();
+	stringstream summary;
+	
+	//device worker pool dispatch latency
+	if(dispatchCount > 0)
+	{
+		summary << fixed << clockEnd << " - Device pool: " << dispatchCount << " operations, mean dispatch latency " << ((dispatchTotal/dispatchCount)*1000000.0) << " usec" << '\n';
+	}
+	
+	//round robin context switches
+	if(quantumCount > 0)
+	{
+		summary << fixed << clockEnd << " - Round robin: " << quantumCount << " quanta expired";
+		
+		if(hostTimings)
+		{
+			summary << ", mean switch overhead " << ((quantumOverhead/quantumCount)*1000000000.0) << " nsec";
+		}
+		
+		summary << '\n';
+	}
+	
+	//shortest time remaining preemptions
+	if(preemptCount > 0)
+	{
+		summary << fixed << clockEnd << " - Shortest time remaining: " << preemptCount << " preemptions" << '\n';
+	}
+	
+	//processor utilization and work stealing
+	for(unsigned int i = 0; i < cores.size(); i++)
+	{
+		summary << fixed << clockEnd << " - Processor " << i << ": " << cores[i].commands << " commands, " << cores[i].steals << " steals, utilization " << (clockEnd > 0.0 ? (cores[i].busyTime/clockEnd)*100.0 : 0.0) << "%" << '\n';
+	}
+
+	//device utilization
+	for(int i = 0; i < NUMdevices; i++)
+	{
+		for(unsigned int j = 0; j < devicePool[i].size() && i != DEVICEcpu; j++)
+		{
+			if(devicePool[i][j]->served > 0)
+			{
+				summary << fixed << clockEnd << " - " << deviceNames[i] << " " << j << ": " << devicePool[i][j]->served << " jobs, utilization " << (clockEnd > 0.0 ? (devicePool[i][j]->busyTime/clockEnd)*100.0 : 0.0) << "%" << '\n';
+			}
+		}
+	}
+	
+	//aggregate throughput
+	if(clockEnd > 0.0)
+	{
+		summary << fixed << clockEnd << " - Throughput: " << finishedCount << " processes, " << (finishedCount/clockEnd) << " processes/sec" << '\n';
+	}
+	
+	//turnaround, waiting and response time of the finished processes
+	vector<double> turnaround;
+	vector<double> waiting;
+	vector<double> response;
+	double busyTime = 0.0;
+	
+	for(unsigned int i = 0; i < processTable.size() && metaStream == 0; i++)
+	{
+		if(processTable[i].finish >= 0.0)
+		{
+			turnaround.push_back(processTable[i].finish - processTable[i].arrival);
+			waiting.push_back(processTable[i].waiting);
+			response.push_back(processTable[i].firstRun - processTable[i].arrival);
+		}
+	}
+	
+	for(unsigned int i = 0; i < cores.size(); i++)
+	{
+		busyTime += cores[i].busyTime;
+	}
+	
+	metricLine(summary, clockEnd, "Turnaround time", turnaround);
+	metricLine(summary, clockEnd, "Waiting time", waiting);
+	metricLine(summary, clockEnd, "Response time", response);
+	
+	//streamed processes are gone, only their totals are kept
+	if(metaStream == 1 && finishedCount > 0)
+	{
+		summary << fixed << clockEnd << " - Turnaround time: mean " << (streamTurnaround/finishedCount) << " sec" << '\n';
+		summary << fixed << clockEnd << " - Waiting time: mean " << (streamWaiting/finishedCount) << " sec" << '\n';
+		summary << fixed << clockEnd << " - Response time: mean " << (streamResponse/finishedCount) << " sec" << '\n';
+	}
+	
+	if(clockEnd > 0.0)
+	{
+		summary << fixed << clockEnd << " - CPU utilization: " << ((busyTime/(clockEnd*cores.size()))*100.0) << "%" << '\n';
+	}
+	
+	writeMetrics(tempConfig.metricsFile);
+	
+	//memory manager
+	if(memoryAllocs + memoryFailed > 0)
+	{
+		const char* policy[] = {"first fit", "best fit", "buddy"};
+		summary << fixed << clockEnd << " - Memory manager: " << policy[memoryPolicy] << ", " << memoryAllocs << " allocations, " << memoryFailed << " failed";
+		
+		if(hostTimings)
+		{
+			summary << ", mean allocation latency " << ((memoryLatency/(memoryAllocs + memoryFailed))*1000000000.0) << " nsec";
+		}
+		
+		summary << '\n';
+		summary << fixed << clockEnd << " - Memory manager: peak use " << memoryPeak << " of " << tempMemory.total << ", mean external fragmentation " << ((memoryFragTotal/(memoryAllocs + memoryFailed))*100.0) << "%, internal fragmentation " << memoryInternal << '\n';
+	}
+	
+	//paging and TLB
+	if(pageAccesses > 0)
+	{
+		const char* policy[] = {"off", "FIFO", "LRU", "clock"};
+		summary << fixed << clockEnd << " - Paging: " << policy[pagingPolicy] << ", peak " << framePeak << " frames, " << processPages << " pages per process, " << tlbSize << " TLB entries, " << pageAccesses << " accesses" << '\n';
+		summary << fixed << clockEnd << " - Paging: " << tlbHits << " TLB hits, " << (pageAccesses - tlbHits) << " TLB misses, " << pageTableHits << " page table hits, " << pageFaults << " page faults, " << pageEvictions << " evictions, TLB hit rate " << ((tlbHits/(double)pageAccesses)*100.0) << "%" << '\n';
+	}
+	
+	//hard drive request scheduling
+	if(!devicePool[DEVICEhdd].empty())
+	{
+		const char* policy[] = {"FCFS", "SSTF", "SCAN", "C-LOOK"};
+		long served = 0;
+		long seekTotal = 0;
+		double waitTotal = 0.0;
+		
+		for(unsigned int i = 0; i < devicePool[DEVICEhdd].size(); i++)
+		{
+			served += devicePool[DEVICEhdd][i]->served;
+			seekTotal += devicePool[DEVICEhdd][i]->seekTotal;
+			waitTotal += devicePool[DEVICEhdd][i]->waitTotal;
+		}
+		
+		if(served > 0)
+		{
+			summary << fixed << clockEnd << " - Disk scheduling: " << policy[diskPolicy] << ", " << served << " requests, mean seek distance " << (seekTotal/(double)served) << " cylinders, mean I/O wait " << (waitTotal/served) << " sec" << '\n';
+		}
+	}
+	
+	//meta-data parse throughput
+	if(parseTime > 0.0 && hostTimings)
+	{
+		summary << fixed << clockEnd << " - Parser: " << parseBytes << " bytes, " << ((parseBytes/1048576.0)/parseTime) << " MB/s" << (metaCompiled ? ", from the compiled file" : "") << '\n';
+	}
+	
+	//cost of formatting each finished task
+	if(formatCount > 0 && hostTimings)
+	{
+		summary << fixed << clockEnd << " - Logger: " << formatCount << " events, mean formatting cost " << ((formatTotal/formatCount)*1000000000.0) << " nsec" << '\n';
+	}
+	
+	summary << fixed << clockEnd << " - Simulator program ending" << '\n';
+	logWrite(summary.str());
+}
+
+//----------------------------------------------------------------------------------------------------
+//memory management
+//----------------------------------------------------------------------------------------------------
+
+/**
+@brief  sets up system memory as one free hole, or as buddy blocks for the buddy allocator
+@param  none
+@return  none
+@pre  readConfig()
+@post  memoryAllocate() hands out blocks from the configured system memory
+**/
+void startMemory()
+{
+	memoryHoles.clear();
+	memoryHoleSizes.clear();
+	memoryBlocks.clear();
+	buddyFree.clear();
+	
+	if(tempMemory.total <= 0)
+	{
+		return;
+	}
+	
+	//the buddy allocator only manages the largest power of two that fits
+	if(memoryPolicy == MEMORYbuddy)
+	{
+		int order = 0;
+		
+		while((2 << order) <= tempMemory.total && order < 30)
+		{
+			order++;
+		}
+		
+		buddyFree.resize(order + 1);
+		buddyFree[order].insert(0);
+	}
+	
+	else
+	{
+		holeInsert(0, tempMemory.total);
+	}
+}
+
+/**
+@brief  finds a free block for a process with the configured policy and records it against the process
+@param  int id, int size
+@return  int address, -1 if no block is big enough
+@pre  startMemory()
+@post  the block is held by the process until memoryRelease(), page frames were given back if it did not fit otherwise
+**/
+int memoryAllocate(int id, int size)
+{
+	double allocStart = wallTime();
+	int held = size;
+	
+	//fragmentation is sampled on every request, before it is served
+	int available = memoryFree();
+	
+	if(available > 0)
+	{
+		memoryFragTotal += 1.0 - (largestHole()/(double)available);
+	}
+	
+	int address = memoryTake(size, held);
+	
+	//paged memory shares the pool, frames give their blocks back until this one fits or none are left
+	while(address < 0 && size > 0 && frameCount > 0)
+	{
+		int frame = pageVictim();
+		pageEvict(frame);
+		memoryGive(frames[frame].address);
+		frames[frame].address = -1;
+		frameCount--;
+		address = memoryTake(size, held);
+	}
+	
+	if(address < 0)
+	{
+		memoryFailed++;
+	}
+	
+	else
+	{
+		processTable[id].memory.push_back(address);
+		memoryAllocs++;
+	}
+	
+	memoryLatency += wallTime() - allocStart;
+	return address;
+}
+
+/**
+@brief  takes a free block of system memory with the configured policy, for a process or a page frame
+@param  int size, int &held
+@return  int address, -1 if no block is big enough or the size is not positive
+@pre  startMemory()
+@post  held is what the block really takes, rounded up for the buddy allocator, and the block is in memoryBlocks
+**/
+int memoryTake(int size, int& held)
+{
+	int address = -1;
+	held = size;
+	
+	if(size <= 0)
+	{
+		return -1;
+	}
+	
+	if(memoryPolicy == MEMORYbuddy)
+	{
+		//round up to a power of two and find the smallest free block that holds it
+		int order = 0;
+		
+		while((1 << order) < size)
+		{
+			order++;
+		}
+		
+		unsigned int found = order;
+		
+		while(found < buddyFree.size() && buddyFree[found].empty())
+		{
+			found++;
+		}
+		
+		if(found < buddyFree.size())
+		{
+			address = *buddyFree[found].begin();
+			buddyFree[found].erase(buddyFree[found].begin());
+			
+			//split it down, freeing the upper halves
+			while((int)found > order)
+			{
+				found--;
+				buddyFree[found].insert(address + (1 << found));
+			}
+			
+			held = 1 << order;
+		}
+	}
+	
+	else
+	{
+		map<int, int>::iterator hole = memoryHoles.end();
+		
+		//lowest address that fits
+		if(memoryPolicy == MEMORYfirst)
+		{
+			for(hole = memoryHoles.begin(); hole != memoryHoles.end(); hole++)
+			{
+				if(hole->second >= size)
+				{
+					break;
+				}
+			}
+		}
+		
+		//smallest hole that fits
+		else
+		{
+			set<pair<int, int> >::iterator best = memoryHoleSizes.lower_bound(make_pair(size, -1));
+			
+			if(best != memoryHoleSizes.end())
+			{
+				hole = memoryHoles.find(best->second);
+			}
+		}
+		
+		if(hole != memoryHoles.end())
+		{
+			address = hole->first;
+			int left = hole->second - size;
+			holeErase(hole);
+			
+			if(left > 0)
+			{
+				holeInsert(address + size, left);
+			}
+		}
+	}
+	
+	if(address >= 0)
+	{
+		memoryBlocks[address] = held;
+		memoryInUse += held;
+		memoryInternal += held - size;
+		memoryPeak = max(memoryPeak, memoryInUse);
+	}
+	
+	return address;
+}
+
+/**
+@brief  frees every block a process holds, joining it with the free memory around it
+@param  processData &tempProcess
+@return  none
+@pre  memoryAllocate()
+@post  the process holds no memory
+**/
+void memoryRelease(processData& tempProcess)
+{
+	for(unsigned int i = 0; i < tempProcess.memory.size(); i++)
+	{
+		memoryGive(tempProcess.memory[i]);
+	}
+	
+	tempProcess.memory.clear();
+}
+
+/**
+@brief  frees one block, joining it with the free memory around it
+@param  int address
+@return  none
+@pre  memoryTake()
+@post  the block is free for the next process or page frame
+**/
+void memoryGive(int address)
+{
+	map<int, int>::iterator block = memoryBlocks.find(address);
+	int size = block->second;
+	memoryBlocks.erase(block);
+	memoryInUse -= size;
+	
+	if(memoryPolicy == MEMORYbuddy)
+	{
+		int order = 0;
+		
+		while((1 << order) < size)
+		{
+			order++;
+		}
+		
+		//merge with the buddy for as long as it is free too
+		while(order + 1 < (int)buddyFree.size())
+		{
+			set<int>::iterator buddy = buddyFree[order].find(address ^ (1 << order));
+			
+			if(buddy == buddyFree[order].end())
+			{
+				break;
+			}
+			
+			buddyFree[order].erase(buddy);
+			address &= ~(1 << order);
+			order++;
+		}
+		
+		buddyFree[order].insert(address);
+	}
+	
+	else
+	{
+		map<int, int>::iterator next = memoryHoles.lower_bound(address);
+		
+		//join the hole after it
+		if(next != memoryHoles.end() && next->first == address + size)
+		{
+			size += next->second;
+			holeErase(next);
+		}
+		
+		//join the hole before it
+		next = memoryHoles.lower_bound(address);
+		
+		if(next != memoryHoles.begin())
+		{
+			map<int, int>::iterator prev = next;
+			prev--;
+			
+			if(prev->first + prev->second == address)
+			{
+				address = prev->first;
+				size += prev->second;
+				holeErase(prev);
+			}
+		}
+		
+		holeInsert(address, size);
+	}
+}
+
+/**
+@brief  adds a free hole, indexed by address and by size
+@param  int address, int size
+@return  none
+@pre  none
+@post  the hole can be found by first fit and best fit
+**/
+void holeInsert(int address, int size)
+{
+	memoryHoles[address] = size;
+	memoryHoleSizes.insert(make_pair(size, address));
+}
+
+/**
+@brief  removes a free hole from both indexes
+@param  map<int, int>::iterator hole
+@return  none
+@pre  holeInsert()
+@post  the hole is no longer free
+**/
+void holeErase(map<int, int>::iterator hole)
+{
+	memoryHoleSizes.erase(make_pair(hole->second, hole->first));
+	memoryHoles.erase(hole);
+}
+
+/**
+@brief  size of the largest free block
+@param  none
+@return  int size
+@pre  startMemory()
+@post  none
+**/
+int largestHole()
+{
+	if(memoryPolicy == MEMORYbuddy)
+	{
+		for(int i = buddyFree.size() - 1; i >= 0; i--)
+		{
+			if(!buddyFree[i].empty())
+			{
+				return 1 << i;
+			}
+		}
+		
+		return 0;
+	}
+	
+	if(memoryHoleSizes.empty())
+	{
+		return 0;
+	}
+	
+	return memoryHoleSizes.rbegin()->first;
+}
+
+/**
+@brief  total free memory the allocator manages
+@param  none
+@return  int size
+@pre  startMemory()
+@post  none
+**/
+int memoryFree()
+{
+	if(memoryPolicy == MEMORYbuddy)
+	{
+		return buddyFree.empty() ? 0 : (1 << (buddyFree.size() - 1)) - memoryInUse;
+	}
+	
+	return tempMemory.total - memoryInUse;
+}
+
+/**
+@brief  empties the frame table and the TLB
+@param  none
+@return  none
+@pre  startMemory()
+@post  pageAccess() takes frames from system memory as pages fault in
+**/
+void startPaging()
+{
+	frames.clear();
+	frameCount = 0;
+	framePeak = 0;
+	tlb.clear();
+	clockHand = 0;
+}
+
+/**
+@brief  touches one page of a process, through the TLB then the page table, faulting it into a frame if needed
+@param  int id, int page
+@return  none
+@pre  startPaging()
+@post  the page is in a frame and in the TLB, unless allocations hold every block of system memory
+**/
+void pageAccess(int id, int page)
+{
+	pageStamp++;
+	pageAccesses++;
+	int frame = -1;
+	
+	//TLB lookup
+	for(unsigned int i = 0; i < tlb.size(); i++)
+	{
+		if(tlb[i].process == id && tlb[i].page == page)
+		{
+			tlbHits++;
+			tlb[i].used = pageStamp;
+			frame = tlb[i].frame;
+			break;
+		}
+	}
+	
+	if(frame < 0)
+	{
+		map<int, int>& pageTable = processTable[id].pages;
+		map<int, int>::iterator entry = pageTable.find(page);
+		
+		if(entry != pageTable.end())
+		{
+			pageTableHits++;
+			frame = entry->second;
+		}
+		
+		//page fault, bring it into a new frame or a victim's
+		else
+		{
+			pageFaults++;
+			frame = pageFrame();
+			
+			//no free memory and no frame to take
+			if(frame < 0)
+			{
+				return;
+			}
+			
+			if(frames[frame].process >= 0)
+			{
+				pageEvict(frame);
+			}
+			
+			frames[frame].process = id;
+			frames[frame].page = page;
+			frames[frame].loaded = pageStamp;
+			pageTable[page] = frame;
+		}
+		
+		//cache the translation, replacing the least recently used entry
+		tlbEntry tempEntry;
+		tempEntry.process = id;
+		tempEntry.page = page;
+		tempEntry.frame = frame;
+		tempEntry.used = pageStamp;
+		
+		if((int)tlb.size() < tlbSize)
+		{
+			tlb.push_back(tempEntry);
+		}
+		
+		else if(tlbSize > 0)
+		{
+			int oldest = 0;
+			
+			for(unsigned int i = 1; i < tlb.size(); i++)
+			{
+				if(tlb[i].used < tlb[oldest].used)
+				{
+					oldest = i;
+				}
+			}
+			
+			tlb[oldest] = tempEntry;
+		}
+	}
+	
+	frames[frame].used = pageStamp;
+	frames[frame].referenced = true;
+}
+
+/**
+@brief  picks the frame for a faulting page, a new one from free system memory if a block fits, otherwise by the replacement policy
+@param  none
+@return  int frame, -1 if there is no free block and no frame
+@pre  startPaging()
+@post  a new frame holds its block and is in the first empty slot
+**/
+int pageFrame()
+{
+	int held = 0;
+	int address = memoryTake(tempMemory.blockSize, held);
+	
+	if(address < 0)
+	{
+		return (frameCount > 0) ? pageVictim() : -1;
+	}
+	
+	unsigned int slot = 0;
+	
+	while(slot < frames.size() && frames[slot].address >= 0)
+	{
+		slot++;
+	}
+	
+	if(slot == frames.size())
+	{
+		frames.push_back(frameData());
+	}
+	
+	frames[slot].address = address;
+	frames[slot].process = -1;
+	frames[slot].page = -1;
+	frames[slot].loaded = 0;
+	frames[slot].used = 0;
+	frames[slot].referenced = false;
+	frameCount++;
+	framePeak = max(framePeak, frameCount);
+	return slot;
+}
+
+/**
+@brief  picks the frame to evict by the replacement policy
+@param  none
+@return  int frame
+@pre  frameCount > 0
+@post  with clock replacement the hand has moved past the victim
+**/
+int pageVictim()
+{
+	int victim = -1;
+	
+	//second chance, clearing reference bits until an unreferenced frame comes round
+	if(pagingPolicy == PAGINGclock)
+	{
+		while(frames[clockHand].address < 0 || frames[clockHand].referenced)
+		{
+			frames[clockHand].referenced = false;
+			clockHand = (clockHand + 1) % frames.size();
+		}
+		
+		victim = clockHand;
+		clockHand = (clockHand + 1) % frames.size();
+		return victim;
+	}
+	
+	//oldest load for FIFO, oldest use for LRU
+	for(unsigned int i = 0; i < frames.size(); i++)
+	{
+		if(frames[i].address < 0)
+		{
+			continue;
+		}
+		
+		if(victim < 0 || (pagingPolicy == PAGINGfifo ? frames[i].loaded < frames[victim].loaded : frames[i].used < frames[victim].used))
+		{
+			victim = i;
+		}
+	}
+	
+	return victim;
+}
+
+/**
+@brief  takes a page away from the process that has it in a frame
+@param  int frame
+@return  none
+@pre  the frame holds a page
+@post  the owner's next access to the page faults, the frame keeps its block
+**/
+void pageEvict(int frame)
+{
+	processTable[frames[frame].process].pages.erase(frames[frame].page);
+	tlbInvalidate(frames[frame].process, frames[frame].page);
+	pageEvictions++;
+	frames[frame].process = -1;
+	frames[frame].page = -1;
+}
+
+/**
+@brief  drops a translation from the TLB
+@param  int id, int page
+@return  none
+@pre  none
+@post  the next access to the page misses the TLB
+**/
+void tlbInvalidate(int id, int page)
+{
+	for(unsigned int i = 0; i < tlb.size(); i++)
+	{
+		if(tlb[i].process == id && tlb[i].page == page)
+		{
+			tlb.erase(tlb.begin() + i);
+			return;
+		}
+	}
+}
+
+/**
+@brief  frees every frame a finished process holds
+@param  processData &tempProcess
+@return  none
+@pre  pageAccess()
+@post  the process has no pages in memory or in the TLB, and their blocks are back in system memory
+**/
+void pageRelease(processData& tempProcess)
+{
+	for(map<int, int>::iterator i = tempProcess.pages.begin(); i != tempProcess.pages.end(); i++)
+	{
+		memoryGive(frames[i->second].address);
+		frames[i->second].address = -1;
+		frames[i->second].process = -1;
+		frames[i->second].page = -1;
+		frames[i->second].referenced = false;
+		frameCount--;
+		tlbInvalidate(tempProcess.id, i->first);
+	}
+	
+	tempProcess.pages.clear();
+}
+
+/**
+@brief  adds the mean and percentiles of one scheduling metric to the summary
+@param  stringstream &summary, double clockEnd, const char *name, vector<double> &values
+@return  none
+@pre  endOutput()
+@post  values is sorted
+**/
+void metricLine(stringstream& summary, double clockEnd, const char* name, vector<double>& values)
+{
+	if(values.empty())
+	{
+		return;
+	}
+	
+	double total = 0.0;
+	
+	for(unsigned int i = 0; i < values.size(); i++)
+	{
+		total += values[i];
+	}
+	
+	sort(values.begin(), values.end());
+	summary << fixed << clockEnd << " - " << name << ": mean " << (total/values.size()) << ", p50 " << percentile(values, 0.50) << ", p95 " << percentile(values, 0.95) << ", p99 " << percentile(values, 0.99) << " sec" << '\n';
+}
+
+/**
+@brief  nearest rank percentile
+@param  const vector<double> &sorted, double fraction
+@return  double value
+@pre  sorted is sorted and not empty
+@post  none
+**/
+double percentile(const vector<double>& sorted, double fraction)
+{
+	unsigned int rank = (unsigned int)(fraction*sorted.size() + 0.999999);
+	
+	if(rank < 1)
+	{
+		rank = 1;
+	}
+	
+	if(rank > sorted.size())
+	{
+		rank = sorted.size();
+	}
+	
+	return sorted[rank - 1];
+}
+
+/**
+@brief  writes one csv row of scheduling metrics per finished process, does nothing without a metrics file
+@param  string filename
+@return  none
+@pre  runScheduler()
+@post  the csv is written and closed
+**/
+void writeMetrics(string filename)
+{
+	//streamed rows are already written
+	if(filename.empty() || metaStream == 1)
+	{
+		streamMetrics.close();
+		return;
+	}
+	
+	ofstream metricsFile(filename.c_str());
+	
+	if(!metricsFile.is_open())
+	{
+		throw runtime_error("metrics file could not be opened");
+	}
+	
+	metricsFile << "process,arrival,first_run,completion,turnaround,waiting,response" << '\n';
+	metricsFile << fixed;
+	
+	for(unsigned int i = 0; i < processTable.size(); i++)
+	{
+		const processData& tempProcess = processTable[i];
+		
+		if(tempProcess.finish >= 0.0)
+		{
+			metricsRow(metricsFile, tempProcess);
+		}
+	}
+	
+	metricsFile.close();
+}
+
+/**
+@brief  writes one process's csv row of scheduling metrics
+@param  ofstream &metricsFile, const processData &tempProcess
+@return  none
+@pre  the process has finished
+@post  none
+**/
+void metricsRow(ofstream& metricsFile, const processData& tempProcess)
+{
+	metricsFile << tempProcess.processCount << ',' << tempProcess.arrival << ',' << tempProcess.firstRun << ',' << tempProcess.finish << ',' << (tempProcess.finish - tempProcess.arrival) << ',' << tempProcess.waiting << ',' << (tempProcess.firstRun - tempProcess.arrival) << '\n';
+}
+
+//----------------------------------------------------------------------------------------------------
+//benchmarks
+//----------------------------------------------------------------------------------------------------
+
+/**
+@brief  runs the parser, memory manager, logger and scheduler one at a time over the configured meta-data and reports each
+@param  string filename, string resultsFile
+@return  none
+@pre  readConfig()
+@post  prints one line per stage and writes the results as JSON
+**/
+void runBenchmarks(string filename, string resultsFile) throw(runtime_error)
+{
+	vector<benchResult> results;
+	
+	//everything on the virtual clock, log lines go nowhere
+	clockMode = CLOCKvirtual;
+	logTo = 'F';
+	logFlush = FLUSHexit;
+	tempConfig.logFile = "/dev/null";
+	tempConfig.traceFile = "";
+	tempConfig.metricsFile = "";
+	
+	//parser
+	readInput(filename);
+	long commands = 0;
+	
+	for(unsigned int i = 0; i < masterPrograms.size(); i++)
+	{
+		commands += masterPrograms[i]->commands.size();
+	}
+	
+	rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+	benchRecord(results, "parser", commands, parseTime, usage.ru_maxrss);
+	
+	//every other stage starts from the parsed workload in a process of its own, so its peak RSS is its own
+	for(int stage = 0; stage < BENCHstages; stage++)
+	{
+		benchStage(results, stage);
+	}
+	
+	//results file
+	ofstream jsonFile(resultsFile.c_str());
+	
+	if(!jsonFile.is_open())
+	{
+		throw runtime_error("benchmark results file could not be opened");
+	}
+	
+	jsonFile << fixed << "{\"workload\":\"" << filename << "\",\"results\":[" << '\n';
+	
+	for(unsigned int i = 0; i < results.size(); i++)
+	{
+		jsonFile << "{\"name\":\"" << results[i].name << "\",\"ops\":" << results[i].ops << ",\"seconds\":" << results[i].seconds << ",\"ops_per_sec\":" << results[i].opsPerSec << ",\"ns_per_op\":" << results[i].nsPerOp << ",\"peak_rss_kb\":" << results[i].peakRSS << "}" << (i + 1 < results.size() ? "," : "") << '\n';
+	}
+	
+	jsonFile << "]}" << '\n';
+	jsonFile.close();
+}
+
+/**
+@brief  runs one benchmark stage in a forked child and records it, the child's peak RSS is the stage's
+@param  vector<benchResult> &results, int stage
+@return  none
+@pre  runBenchmarks()
+@post  the parent's globals are untouched by the stage
+**/
+void benchStage(vector<benchResult>& results, int stage) throw(runtime_error)
+{
+	//the result comes back through shared memory, the same way forkRuns() does it
+	benchResult* tempResult = (benchResult*)mmap(NULL, sizeof(benchResult), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+	
+	if(tempResult == MAP_FAILED)
+	{
+		throw runtime_error("benchmark results could not be mapped");
+	}
+	
+	memset(tempResult, 0, sizeof(benchResult));
+	cout.flush();
+	pid_t pid = fork();
+	
+	if(pid < 0)
+	{
+		munmap(tempResult, sizeof(benchResult));
+		throw runtime_error("benchmark stage could not be started");
+	}
+	
+	if(pid == 0)
+	{
+		benchRun(stage, *tempResult);
+		_exit(0);
+	}
+	
+	int status = 0;
+	rusage usage;
+	
+	if(wait4(pid, &status, 0, &usage) < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0 || tempResult->name == NULL)
+	{
+		munmap(tempResult, sizeof(benchResult));
+		throw runtime_error("benchmark stage ended without a result");
+	}
+	
+	benchResult stageResult = *tempResult;
+	munmap(tempResult, sizeof(benchResult));
+	benchRecord(results, stageResult.name, stageResult.ops, stageResult.seconds, usage.ru_maxrss);
+}
+
+/**
+@brief  runs one benchmark stage, the memory manager under each policy over the same allocate and free pattern, the logger or the whole scheduler
+@param  int stage, benchResult &tempResult
+@return  none
+@pre  benchStage()
+@post  tempResult holds the stage's name, operations and wall time
+**/
+void benchRun(int stage, benchResult& tempResult)
+{
+	//memory manager
+	if(stage <= MEMORYbuddy)
+	{
+		const char* policies[] = {"memory first fit", "memory best fit", "memory buddy"};
+		memoryPolicy = stage;
+		startMemory();
+		unsigned long seed = 1;
+		long ops = 0;
+		int holders = min((int)processTable.size(), BENCHholders);
+		
+		//requests are sized so the live blocks fill about half of system memory, most succeed and the holes stay realistic
+		int mean = max(tempMemory.total/(2*BENCHholders*BENCHholding), 1);
+		double start = wallTime();
+		
+		for(long i = 0; i < BENCHmemoryOps && holders > 0; i++)
+		{
+			int id = i % holders;
+			seed = seed*6364136223846793005UL + 1442695040888963407UL;
+			
+			if(processTable[id].memory.size() >= (unsigned int)BENCHholding)
+			{
+				memoryRelease(processTable[id]);
+				ops++;
+			}
+			
+			//out of memory, a random holder gives its blocks back
+			if(memoryAllocate(id, 1 + (int)((seed >> 33) % (2*mean))) < 0)
+			{
+				memoryRelease(processTable[(seed >> 17) % holders]);
+				ops++;
+			}
+			
+			ops++;
+		}
+		
+		for(int i = 0; i < holders; i++)
+		{
+			memoryRelease(processTable[i]);
+		}
+		
+		tempResult.seconds = wallTime() - start;
+		tempResult.ops = ops;
+		tempResult.name = policies[stage];
+	}
+	
+	//logger, formatted lines through the ring and the flusher
+	else if(stage == MEMORYbuddy + 1)
+	{
+		char line[LOGslotSize];
+		double logStart = wallTime();
+		startLogger(tempConfig.logFile);
+		
+		for(long i = 0; i < BENCHlogOps; i++)
+		{
+			int length = snprintf(line, sizeof(line), "%f - Process %ld: start processing action\n", i/1000.0, i);
+			logWrite(line, length);
+		}
+		
+		stopLogger();
+		tempResult.seconds = wallTime() - logStart;
+		tempResult.ops = BENCHlogOps;
+		tempResult.name = "logger";
+	}
+	
+	//scheduler, the whole simulation of the parsed processes
+	else
+	{
+		startMemory();
+		startLogger(tempConfig.logFile);
+		startDevicePool();
+		double scheduleStart = wallTime();
+		runScheduler();
+		double scheduleTime = wallTime() - scheduleStart;
+		long jobs = 0;
+		
+		for(int i = 0; i < NUMdevices; i++)
+		{
+			for(unsigned int j = 0; j < devicePool[i].size(); j++)
+			{
+				jobs += devicePool[i][j]->served;
+			}
+		}
+		
+		stopDevicePool();
+		stopLogger();
+		tempResult.seconds = scheduleTime;
+		tempResult.ops = jobs;
+		tempResult.name = "scheduler";
+	}
+}
+
+/**
+@brief  adds one benchmark stage to the results and prints it
+@param  vector<benchResult> &results, const char *name, long ops, double seconds, long peakRSS
+@return  none
+@pre  runBenchmarks()
+@post  the stage is in results with the peak resident set size of the process that ran it
+**/
+void benchRecord(vector<benchResult>& results, const char* name, long ops, double seconds, long peakRSS)
+{
+	benchResult tempResult;
+	tempResult.name = name;
+	tempResult.ops = ops;
+	tempResult.seconds = seconds;
+	tempResult.opsPerSec = (seconds > 0.0) ? ops/seconds : 0.0;
+	tempResult.nsPerOp = (ops > 0) ? (seconds/ops)*1000000000.0 : 0.0;
+	tempResult.peakRSS = peakRSS;
+	results.push_back(tempResult);
+	
+	cout << fixed << setprecision(1) << left << setw(18) << name << right << setw(12) << ops << " ops " << setw(14) << tempResult.opsPerSec << " ops/sec " << setw(10) << tempResult.nsPerOp << " ns/op " << setw(8) << tempResult.peakRSS << " KB peak RSS" << '\n';
+	cout << resetiosflags(ios::fixed) << setprecision(6);
+}
+
+//----------------------------------------------------------------------------------------------------
+//batch runs
+//----------------------------------------------------------------------------------------------------
+
+/**
+@brief  runs every config in a manifest, one per line, with as many simulations at once as there are processors
+@param  string filename, string summaryFile
+@return  none
+@pre  none
+@post  each run has its own log and the summary file holds one csv row per run in manifest order
+**/
+void runBatch(string filename, string summaryFile) throw(runtime_error)
+{
+	ifstream fin(filename.c_str());
+	string line;
+	
+	if(!fin.good())
+	{
+		throw runtime_error("batch manifest not found");
+	}
+	
+	//one config path per line, blank lines and # comments skipped
+	while(getline(fin, line))
+	{
+		size_t first = line.find_first_not_of(" \t\r");
+		size_t last = line.find_last_not_of(" \t\r");
+		
+		if(first != string::npos && line[first] != '#')
+		{
+			batchConfigs.push_back(line.substr(first, last - first + 1));
+		}
+	}
+	
+	fin.close();
+	
+	if(batchConfigs.empty())
+	{
+		return;
+	}
+	
+	long workers = 0;
+	double start = wallTime();
+	runSummary* results = forkRuns(batchConfigs.size(), batchRun, workers);
+	
+	//combined summary
+	ofstream csvFile(summaryFile.c_str());
+	int failed = 0;
+	
+	if(!csvFile.is_open())
+	{
+		munmap(results, batchConfigs.size()*sizeof(runSummary));
+		throw runtime_error("batch summary file could not be opened");
+	}
+	
+	csvFile << "config,status,processes,sim_seconds,mean_turnaround,mean_waiting,mean_response,context_switches,wall_seconds,error" << '\n';
+	csvFile << fixed;
+	
+	for(unsigned int i = 0; i < batchConfigs.size(); i++)
+	{
+		const runSummary& tempRun = results[i];
+		csvFile << csvField(batchConfigs[i]) << ',' << tempRun.status << ',' << tempRun.processes << ',' << tempRun.clockEnd << ',' << tempRun.turnaround << ',' << tempRun.waiting << ',' << tempRun.response << ',' << tempRun.switches << ',' << tempRun.seconds << ',' << csvField(tempRun.error) << '\n';
+		
+		if(tempRun.status != 0)
+		{
+			failed++;
+		}
+	}
+	
+	csvFile.close();
+	munmap(results, batchConfigs.size()*sizeof(runSummary));
+	cout << fixed << "Batch: " << batchConfigs.size() << " runs, " << failed << " failed, " << workers << " at a time, " << (wallTime() - start) << " sec" << '\n';
+}
+
+/**
+@brief  runs one config of a batch in a forked process, always logging to a file named after the config, with any trace and metrics files beside it
+@param  unsigned int index, runSummary &tempRun
+@return  none
+@pre  runBatch()
+@post  tempRun holds the run's results or the error that stopped it
+**/
+void batchRun(unsigned int index, runSummary& tempRun)
+{
+	string filename = batchConfigs[index];
+	double start = wallTime();
+	
+	try
+	{
+		readConfig(&filename[0]);
+		
+		//runs share the monitor and usually the same output paths, so each writes beside its config
+		size_t dot = filename.find_last_of('.');
+		size_t slash = filename.find_last_of('/');
+		string base = (dot != string::npos && (slash == string::npos || dot > slash)) ? filename.substr(0, dot) : filename;
+		tempConfig.logFile = base + ".lgf";
+		logTo = 'F';
+		
+		if(!tempConfig.traceFile.empty())
+		{
+			tempConfig.traceFile = base + ".trace.json";
+		}
+		
+		if(!tempConfig.metricsFile.empty())
+		{
+			tempConfig.metricsFile = base + ".metrics.csv";
+		}
+		
+		readInput(tempConfig.inputFile);
+		runSimulation();
+		summarizeRun(tempRun);
+		tempRun.status = 0;
+	}
+	
+	catch(const exception& e)
+	{
+		tempRun.status = 1;
+		snprintf(tempRun.error, sizeof(tempRun.error), "%s", e.what());
+	}
+	
+	tempRun.seconds = wallTime() - start;
+}
+
+/**
+@brief  quotes a field for the batch summary when it holds a comma, a quote or a line break
+@param  const string &field
+@return  string the field as it goes in the CSV
+@pre  none
+@post  quotes inside a quoted field are doubled
+**/
+string csvField(const string& field)
+{
+	if(field.find_first_of(",\"\r\n") == string::npos)
+	{
+		return field;
+	}
+	
+	string quoted = "\"";
+	
+	for(unsigned int i = 0; i < field.size(); i++)
+	{
+		if(field[i] == '"')
+		{
+			quoted += '"';
+		}
+		
+		quoted += field[i];
+	}
+	
+	return quoted + "\"";
+}
+
+/**
+@brief  runs the configured meta-data once per quantum, and per processor cycle time if any are given, and prints a table of the results
+@param  string quanta, string cycles
+@return  none
+@pre  readConfig()
+@post  the meta-data is parsed once, every forked run starts from the same parsed processes
+**/
+void runSweep(string quanta, string cycles) throw(runtime_error)
+{
+	vector<int> quantumList;
+	vector<int> cycleList;
+	sweepValues(quanta, quantumList);
+	
+	if(cycles.empty())
+	{
+		cycleList.push_back(0);
+	}
+	
+	else
+	{
+		sweepValues(cycles, cycleList);
+	}
+	
+	if(quantumList.size()*cycleList.size() > (unsigned int)SWEEPmaxRuns)
+	{
+		throw runtime_error("sweep has too many runs");
+	}
+	
+	for(unsigned int i = 0; i < cycleList.size(); i++)
+	{
+		for(unsigned int j = 0; j < quantumList.size(); j++)
+		{
+			sweepSettings.push_back(make_pair(quantumList[j], cycleList[i]));
 		}
 	}
 	
-	//close file
-	fin.close();
+	//the virtual clock, log lines go nowhere, only the table is wanted
+	clockMode = CLOCKvirtual;
+	logTo = 'F';
+	logFlush = FLUSHexit;
+	tempConfig.logFile = "/dev/null";
+	tempConfig.traceFile = "";
+	tempConfig.metricsFile = "";
 	
-	//running timer process using temp queue
-	processData tempProcess;
+	if(rrs == false)
+	{
+		cout << "Sweep: the config does not use RR, the quantum has no effect" << '\n';
+	}
 	
-	//if shortest time first scheduling
-	if (strs == true)
+	readInput(tempConfig.inputFile);
+	
+	//the runs would all read the one stream
+	if(metaStream == 1)
+	{
+		throw runtime_error("a sweep needs a meta-data file, not a stream");
+	}
+	
+	long workers = 0;
+	double start = wallTime();
+	runSummary* results = forkRuns(sweepSettings.size(), sweepRun, workers);
+	int best = -1;
+	
+	cout << fixed << setprecision(6) << right << setw(8) << "quantum" << setw(8) << "cycle" << setw(12) << "processes" << setw(16) << "turnaround" << setw(16) << "waiting" << setw(12) << "switches" << '\n';
+	
+	for(unsigned int i = 0; i < sweepSettings.size(); i++)
 	{
-		startOutput(tempConfig.logFile);
+		const runSummary& tempRun = results[i];
+		cout << setw(8) << sweepSettings[i].first << setw(8) << (sweepSettings[i].second > 0 ? sweepSettings[i].second : tempConfig.pct);
 		
-		while(!strQueue.empty())
+		if(tempRun.status != 0)
 		{
-			tempProcess = strQueue.top();
-			timerProcess(tempProcess);
-			strQueue.pop();
+			cout << "  " << tempRun.error << '\n';
+			continue;
 		}
 		
-		endOutput(tempConfig.logFile);
+		cout << setw(12) << tempRun.processes << setw(16) << tempRun.turnaround << setw(16) << tempRun.waiting << setw(12) << tempRun.switches << '\n';
+		
+		if(best < 0 || tempRun.turnaround < results[best].turnaround)
+		{
+			best = i;
+		}
 	}
 	
-	//if round robin scheduling
-	else
+	if(best >= 0)
+	{
+		cout << "Best mean turnaround: quantum " << sweepSettings[best].first << ", cycle " << (sweepSettings[best].second > 0 ? sweepSettings[best].second : tempConfig.pct) << '\n';
+	}
+	
+	cout << "Sweep: " << sweepSettings.size() << " runs, " << workers << " at a time, " << (wallTime() - start) << " sec" << '\n';
+	munmap(results, sweepSettings.size()*sizeof(runSummary));
+}
+
+/**
+@brief  runs one quantum and cycle time of a sweep in a forked process
+@param  unsigned int index, runSummary &tempRun
+@return  none
+@pre  runSweep()
+@post  tempRun holds the run's results or the error that stopped it
+**/
+void sweepRun(unsigned int index, runSummary& tempRun)
+{
+	double start = wallTime();
+	
+	try
 	{
-		startOutput(tempConfig.logFile);
+		tempConfig.pqn = sweepSettings[index].first;
 		
-		while(!rrQueue.empty())
-		{	
-			tempProcess = rrQueue.front();
-			timerProcess(tempProcess);
-			rrQueue.pop();
+		if(sweepSettings[index].second > 0)
+		{
+			tempConfig.pct = sweepSettings[index].second;
+			applyCycleTimes();
 		}
 		
-		endOutput(tempConfig.logFile);
+		runSimulation();
+		summarizeRun(tempRun);
+		tempRun.status = 0;
 	}
 	
-
+	catch(const exception& e)
+	{
+		tempRun.status = 1;
+		snprintf(tempRun.error, sizeof(tempRun.error), "%s", e.what());
+	}
+	
+	tempRun.seconds = wallTime() - start;
 }
+
 /**
-@brief  a function that outputs the data stored in the global structs for the config and meta-data
-@param  string filename
+@brief  reads a list of sweep values, each a number, a range first-last or a stepped range first-last:step, separated by commas
+@param  string text, vector<int> &values
 @return  none
-@pre  timerProcess()
-@post  prints to file, monitor or both with the information taken from the user's config and meta-data information 
+@pre  none
+@post  values holds every value in order
 **/
-void output(string filename, string tempCode, string tempCommand, int tempCount, double tempStart, double tempEnd)
+void sweepValues(string text, vector<int>& values) throw(runtime_error)
 {
-	//open file
-	ofstream fout;
-	fout.open(filename.c_str(),ios::app);
+	stringstream items(text);
+	string item;
 	
-	double currentClock = (clock()-clockStart)/(double)(CLOCKS_PER_SEC);
-	
-	//input operation
-	if(tempCode == "input")
-	{	
-		//keyboard command
-		if(tempCommand == "keyboard")
+	while(getline(items, item, ','))
+	{
+		int first = 0;
+		int last = 0;
+		int step = 1;
+		char dash = 0;
+		char colon = 0;
+		stringstream fields(item);
+		bool bad = !(fields >> first);
+		last = first;
+		
+		if(!bad && (fields >> dash))
 		{
-			if(logTo == 'M')
-			{
-				cout << fixed << tempStart << " - Process " << tempCount << ": start keyboard input" << endl;
-				cout << fixed << tempEnd << " - Process " << tempCount << ": end keyboard input" << endl;
-			}
-				
-			else if(logTo == 'F')
-			{
-				fout << fixed << tempStart << " - Process " << tempCount << ": start keyboard input" << endl;
-				fout << fixed << tempEnd << " - Process " << tempCount << ": end keyboard input" << endl;
-			}
+			bad = (dash != '-') || !(fields >> last);
 			
-			else
+			if(!bad && (fields >> colon))
 			{
-				cout << fixed << tempStart << " - Process " << tempCount << ": start keyboard input" << endl;
-				cout << fixed << tempEnd << " - Process " << tempCount << ": end keyboard input" << endl;
-				fout << fixed << tempStart << " - Process " << tempCount << ": start keyboard input" << endl;
-				fout << fixed << tempEnd << " - Process " << tempCount << ": end keyboard input" << endl;
+				bad = (colon != ':') || !(fields >> step);
 			}
 		}
-			
-		//hdd command
-		else if(tempCode == "hdd")
-		{
-			if(logTo == 'M')
-			{
-				cout << fixed << tempStart << " - Process " << tempCount << ": start hard drive input on HDD " << (tempConfig.countHDDIn % tempConfig.numHDD) << endl;
-				cout << fixed << tempEnd << " - Process " << tempCount << ": end hard drive input on HDD " << (tempConfig.countHDDIn % tempConfig.numHDD) << endl;
-			}
 		
-			else if(logTo == 'F')
-			{
-				fout << fixed << tempStart << " - Process " << tempCount << ": start hard drive input on HDD " << (tempConfig.countHDDIn % tempConfig.numHDD) << endl;
-				fout << fixed << tempEnd << " - Process " << tempCount << ": end hard drive input on HDD " << (tempConfig.countHDDIn % tempConfig.numHDD) << endl;
-			}
-			
-			else
-			{
-				cout << fixed << tempStart << " - Process " << tempCount << ": start hard drive input on HDD " << (tempConfig.countHDDIn % tempConfig.numHDD) << endl;
-				cout << fixed << tempEnd << " - Process " << tempCount << ": end hard drive input on HDD " << (tempConfig.countHDDIn % tempConfig.numHDD) << endl;
-				fout << fixed << tempStart << " - Process " << tempCount << ": start hard drive input on HDD " << (tempConfig.countHDDIn % tempConfig.numHDD) << endl;
-				fout << fixed << tempEnd << " - Process " << tempCount << ": end hard drive input on HDD " << (tempConfig.countHDDIn % tempConfig.numHDD) << endl;
-			}
-
-			tempConfig.countHDDIn++;
-		}
-			
-		//scanner command
-		else if(tempCommand == "scanner")
+		if(bad || first < 1 || last < first || step < 1)
 		{
-			if(logTo == 'M')
-			{
-				cout << fixed << tempStart << " - Process " << tempCount << ": start scanner input" << endl;
-				cout << fixed << tempEnd << " - Process " << tempCount << ": end scanner input" << endl;
-			}
+			throw runtime_error("bad sweep value " + item);
+		}
 		
-			else if(logTo == 'F')
-			{
-				fout << fixed << tempStart << " - Process " << tempCount << ": start scanner input" << endl;
-				fout << fixed << tempEnd << " - Process " << tempCount << ": end scanner input" << endl;
-			}
-			
-			else
-			{
-				cout << fixed << tempStart << " - Process " << tempCount << ": start scanner input" << endl;
-				cout << fixed << tempEnd << " - Process " << tempCount << ": end scanner input" << endl;
-				fout << fixed << tempStart << " - Process " << tempCount << ": start scanner input" << endl;
-				fout << fixed << tempEnd << " - Process " << tempCount << ": end scanner input" << endl;
-			}
+		for(long value = first; value <= last && values.size() <= (unsigned int)SWEEPmaxRuns; value += step)
+		{
+			values.push_back(value);
 		}
 	}
-		
-	//output operation
-	else if(tempCode == "output")
+	
+	if(values.empty())
+	{
+		throw runtime_error("sweep has no values");
+	}
+}
+
+/**
+@brief  runs count simulations, each in its own forked copy of this process, with as many at once as there are processors
+@param  unsigned int count, void (*run)(unsigned int, runSummary&), long &workers
+@return  runSummary* results in run order, shared with the runs, munmap() them when done
+@pre  no threads are running, the runs inherit everything parsed so far
+@post  workers is how many ran at once, runs that died without reporting are marked as crashed
+**/
+runSummary* forkRuns(unsigned int count, void (*run)(unsigned int, runSummary&), long& workers) throw(runtime_error)
+{
+	//results come back through shared memory, each run's simulation globals are its own copy
+	runSummary* results = (runSummary*)mmap(NULL, count*sizeof(runSummary), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+	
+	if(results == MAP_FAILED)
+	{
+		throw runtime_error("run results could not be mapped");
+	}
+	
+	for(unsigned int i = 0; i < count; i++)
+	{
+		memset(&results[i], 0, sizeof(runSummary));
+		results[i].status = -1;
+	}
+	
+	workers = max(sysconf(_SC_NPROCESSORS_ONLN), 1L);
+	map<pid_t, unsigned int> running;
+	unsigned int next = 0;
+	cout.flush();
+	
+	while(next < count || !running.empty())
 	{
-		//monitor command
-		if(tempCommand == "monitor")
+		if(next < count && (long)running.size() < workers)
 		{
-			if(logTo == 'M')
-			{
-				cout << fixed << tempStart << " - Process " << tempCount << ": start monitor output" << endl;
-				cout << fixed << tempEnd << " - Process " << tempCount << ": end monitor output" << endl;
-			}
-			else if(logTo == 'F')
+			pid_t pid = fork();
+			
+			if(pid < 0)
 			{
-				fout << fixed << tempStart << " - Process " << tempCount << ": start monitor output" << endl;
-				fout << fixed << tempEnd << " - Process " << tempCount << ": end monitor output" << endl;
+				munmap(results, count*sizeof(runSummary));
+				throw runtime_error("run could not be started");
 			}
 			
-			else
+			if(pid == 0)
 			{
-				cout << fixed << tempStart << " - Process " << tempCount << ": start monitor output" << endl;
-				cout << fixed << tempEnd << " - Process " << tempCount << ": end monitor output" << endl;
-				fout << fixed << tempStart << " - Process " << tempCount << ": start monitor output" << endl;
-				fout << fixed << tempEnd << " - Process " << tempCount << ": end monitor output" << endl;
+				run(next, results[next]);
+				cout.flush();
+				_exit(0);
 			}
+			
+			running[pid] = next;
+			next++;
+			continue;
 		}
 		
-		//projector command
-		else if(tempCommand == "projector")
+		//wait for a run to end before starting another
+		int status = 0;
+		pid_t pid = waitpid(-1, &status, 0);
+		
+		if(pid < 0)
 		{
-			if(logTo == 'M')
-			{
-				cout << fixed << tempStart << " - Process " << tempCount << ": start projector output on PROJ " << (tempConfig.countProjOut % tempConfig.numProj) << endl;
-				cout << fixed << tempEnd << " - Process " << tempCount << ": end projector output on PROJ " << (tempConfig.countProjOut % tempConfig.numProj) << endl;
-			}
-			else if(logTo == 'F')
-			{
-				fout << fixed << tempStart << " - Process " << tempCount << ": start projector output on PROJ " << (tempConfig.countProjOut % tempConfig.numProj) << endl;
-				fout << fixed << tempEnd << " - Process " << tempCount << ": end projector output on PROJ " << (tempConfig.countProjOut % tempConfig.numProj) << endl;
-			}
-			
-			else
-			{
-				cout << fixed << tempStart << " - Process " << tempCount << ": start projector output on PROJ " << (tempConfig.countProjOut % tempConfig.numProj) << endl;
-				cout << fixed << tempEnd << " - Process " << tempCount << ": end projector output on PROJ " << (tempConfig.countProjOut % tempConfig.numProj) << endl;
-				fout << fixed << tempStart << " - Process " << tempCount << ": start projector output on PROJ " << (tempConfig.countProjOut % tempConfig.numProj) << endl;
-				fout << fixed << tempEnd << " - Process " << tempCount << ": end projector output on PROJ " << (tempConfig.countProjOut % tempConfig.numProj) << endl;
-			}
+			break;
+		}
 		
-			tempConfig.countProjOut++;
+		map<pid_t, unsigned int>::iterator tempRun = running.find(pid);
+		
+		if(tempRun == running.end())
+		{
+			continue;
 		}
 		
-		//hdd command
-		else if(tempCommand == "hdd")
+		if(results[tempRun->second].status < 0 || !WIFEXITED(status))
 		{
-			if(logTo == 'M')
-			{
-				cout << fixed << tempStart << " - Process " << tempCount << ": start hard drive output on HDD " << (tempConfig.countHDDOut % tempConfig.numHDD) << endl;
-				cout << fixed << tempEnd << " - Process " << tempCount << ": end hard drive output on HDD " << (tempConfig.countHDDOut % tempConfig.numHDD) << endl;
-			}
-			else if(logTo == 'F')
-			{
-				fout << fixed << tempStart << " - Process " << tempCount << ": start hard drive output on HDD " << (tempConfig.countHDDOut % tempConfig.numHDD) << endl;
-				fout << fixed << tempEnd << " - Process " << tempCount << ": end hard drive output on HDD " << (tempConfig.countHDDOut % tempConfig.numHDD) << endl;
-			}
-			
-			else
-			{
-				cout << fixed << tempStart << " - Process " << tempCount << ": start hard drive output on HDD " << (tempConfig.countHDDOut % tempConfig.numHDD) << endl;
-				cout << fixed << tempEnd << " - Process " << tempCount << ": end hard drive output on HDD " << (tempConfig.countHDDOut % tempConfig.numHDD) << endl;
-				fout << fixed << tempStart << " - Process " << tempCount << ": start hard drive output on HDD " << (tempConfig.countHDDOut % tempConfig.numHDD) << endl;
-				fout << fixed << tempEnd << " - Process " << tempCount << ": end hard drive output on HDD " << (tempConfig.countHDDOut % tempConfig.numHDD) << endl;
-			}
+			results[tempRun->second].status = 2;
+			snprintf(results[tempRun->second].error, sizeof(results[tempRun->second].error), "run ended without a result");
+		}
 		
-			tempConfig.countHDDOut++;
+		running.erase(tempRun);
+	}
+	
+	return results;
+}
+
+/**
+@brief  reduces a finished simulation to the numbers the batch summary reports
+@param  runSummary &tempRun
+@return  none
+@pre  runSimulation()
+@post  fills everything but status, seconds and error
+**/
+void summarizeRun(runSummary& tempRun)
+{
+	double turnaround = 0.0;
+	double waiting = 0.0;
+	double response = 0.0;
+	long finished = 0;
+	
+	for(unsigned int i = 0; i < processTable.size(); i++)
+	{
+		if(processTable[i].finish >= 0.0)
+		{
+			turnaround += processTable[i].finish - processTable[i].arrival;
+			waiting += processTable[i].waiting;
+			response += processTable[i].firstRun - processTable[i].arrival;
+			finished++;
 		}
 	}
+	
+	tempRun.processes = finished;
+	tempRun.clockEnd = currentTime();
+	tempRun.turnaround = (finished > 0) ? turnaround/finished : 0.0;
+	tempRun.waiting = (finished > 0) ? waiting/finished : 0.0;
+	tempRun.response = (finished > 0) ? response/finished : 0.0;
+	tempRun.switches = quantumCount + preemptCount;
+}
+
+/**
+@brief  works every parsed command's cycle time and time left out again from tempConfig, for runs that change cycle times after parsing
+@param  none
+@return  none
+@pre  readInput(), no process has run yet
+@post  the processes start their first command at its new cycle time and the STR heaps are in order again
+**/
+void applyCycleTimes()
+{
+	for(unsigned int i = 0; i < programs.size(); i++)
+	{
+		programTimes(programs[i]);
+	}
+	
+	for(unsigned int i = 0; i < processTable.size(); i++)
+	{
+		processTable[i].remaining = processTable[i].program->commands[processTable[i].pc].cycleTime;
+	}
+	
+	//time remaining has changed under the heaps
+	for(unsigned int i = 0; i < cores.size() && strs == true; i++)
+	{
+		vector<int> ready = cores[i].strHeap;
+		cores[i].strHeap.clear();
 		
-	else
+		for(unsigned int j = 0; j < ready.size(); j++)
+		{
+			strPush(i, ready[j]);
+		}
+	}
+}
+
+//----------------------------------------------------------------------------------------------------
+//logging
+//----------------------------------------------------------------------------------------------------
+
+/**
+@brief  opens the log file once and starts the background flusher
+@param  string filename
+@return  none
+@pre  readConfig()
+@post  logWrite() can be called from any simulation thread until stopLogger()
+**/
+void startLogger(string filename)
+{
+	logRing = new logSlot[LOGslots];
+	
+	for(unsigned long i = 0; i < LOGslots; i++)
+	{
+		logRing[i].sequence.store(i, memory_order_relaxed);
+	}
+	
+	logHead.store(0, memory_order_relaxed);
+	logTail = 0;
+	logRunning.store(true, memory_order_release);
+	
+	if(logTo != 'M')
 	{
-		//memory operation
-		if(tempCode == "memory")
+		logFile.open(filename.c_str(), ios::app);
+	}
+	
+	pthread_create(&logThread, NULL, &logFlusher, NULL);
+}
+
+/**
+@brief  drains what is left in the ring, flushes and closes the log file
+@param  none
+@return  none
+@pre  startLogger()
+@post  every line written before the call is on the monitor and/or in the file
+**/
+void stopLogger()
+{
+	logRunning.store(false, memory_order_release);
+	pthread_join(logThread, NULL);
+	
+	if(logFile.is_open())
+	{
+		logFile.close();
+	}
+	
+	delete[] logRing;
+	logRing = NULL;
+}
+
+/**
+@brief  puts formatted log text on the ring without taking a lock, waits only if the ring is full
+@param  string text
+@return  none
+@pre  startLogger()
+@post  the flusher thread writes the text in order
+**/
+void logWrite(string text)
+{
+	logWrite(text.data(), text.size());
+}
+
+/**
+@brief  puts formatted log text on the ring without taking a lock, waits only if the ring is full
+@param  const char *text, int length
+@return  none
+@pre  startLogger()
+@post  the flusher thread writes the text in order, text from other threads never lands inside it
+**/
+void logWrite(const char* text, int length)
+{
+	int offset = 0;
+	
+	//text longer than a slot takes several slots, all claimed at once so other writers cannot split it
+	while(offset < length)
+	{
+		unsigned long count = min((unsigned long)((length - offset + LOGslotSize - 1)/LOGslotSize), LOGslots);
+		unsigned long position = logHead.load(memory_order_relaxed);
+		
+		while(true)
 		{
-			//allocate command
-			if(tempCommand == "allocate")
+			//the flusher frees slots in order, so the run is free if its last slot is
+			logSlot* lastSlot = &logRing[(position + count - 1) & (LOGslots - 1)];
+			long diff = (long)lastSlot->sequence.load(memory_order_acquire) - (long)(position + count - 1);
+			
+			if(diff == 0)
 			{
-				if(tempMemory.count > tempMemory.total)
-				{
-					tempMemory.count = 0;
-				}
-				
-				if(logTo == 'M')
+				if(logHead.compare_exchange_weak(position, position + count, memory_order_relaxed))
 				{
-					cout << fixed << tempStart << " - Process " << tempCount << ": allocating memory" << endl;
-					cout << fixed << tempEnd << " - Process " << tempCount << ": memory allocated at " << "0x" << setfill('0') << setw(8) << hex << tempMemory.count << dec << endl;
+					break;
 				}
-		
-				else if(logTo == 'F')
-				{
-					fout << fixed << tempStart << " - Process " << tempCount << ": allocating memory" << endl;
-					fout << fixed << tempEnd << " - Process " << tempCount << ": memory allocated at " << "0x" << setfill('0') << setw(8) << hex << tempMemory.count << dec << endl;
-				}
-				
-				else
-				{
-					cout << fixed << tempStart << " - Process " << tempCount << ": allocating memory" << endl;
-					cout << fixed << tempEnd << " - Process " << tempCount << ": memory allocated at " << "0x" << setfill('0') << setw(8) << hex << tempMemory.count << dec << endl;
-					fout << fixed << tempStart << " - Process " << tempCount << ": allocating memory" << endl;
-					fout << fixed << tempEnd << " - Process " << tempCount << ": memory allocated at " << "0x" << setfill('0') << setw(8) << hex << tempMemory.count << dec << endl;
-				}
-				
-				tempMemory.count += tempMemory.blockSize;
 			}
 			
-			//block command
-			else if(tempCommand == "block")
+			//ring is full, let the flusher catch up
+			else if(diff < 0)
 			{
-				if(logTo == 'M')
-				{
-					cout << fixed << tempStart << " - Process " << tempCount << ": start memory blocking" << endl;
-					cout << fixed << tempEnd << " - Process " << tempCount << ": end memory blocking" << endl;
-				}
-				
-				else if(logTo == 'F')
-				{
-					fout << fixed << tempStart << " - Process " << tempCount << ": start memory blocking" << endl;
-					fout << fixed << tempEnd << " - Process " << tempCount << ": end memory blocking" << endl;
-				}
-				
-				else
-				{
-					cout << fixed << tempStart << " - Process " << tempCount << ": start memory blocking" << endl;
-					cout << fixed << tempEnd << " - Process " << tempCount << ": end memory blocking" << endl;
-					fout << fixed << tempStart << " - Process " << tempCount << ": start memory blocking" << endl;
-					fout << fixed << tempEnd << " - Process " << tempCount << ": end memory blocking" << endl;
-				}
-				
-			}
-		}
-		
-		//application
-		else if(tempCode == "application")
-		{
-			//start process
-			if(tempCommand == "start")
-			{	
-				if(logTo == 'M')
-				{
-					cout << fixed << tempStart << " - OS: preparing process " << tempCount << endl;
-					cout << fixed << tempStart << " - OS: starting process " << tempCount << endl;
-				}
-				
-				else if(logTo == 'F')
-				{
-					fout << fixed << tempStart << " - OS: preparing process " << tempCount << endl;
-					fout << fixed << tempStart << " - OS: starting process " << tempCount << endl;
-				}
-				
-				else
-				{
-					cout << fixed << tempStart << " - OS: preparing process " << tempCount << endl;
-					cout << fixed << tempStart << " - OS: starting process " << tempCount << endl;
-					fout << fixed << tempStart << " - OS: preparing process " << tempCount << endl;
-					fout << fixed << tempStart << " - OS: starting process " << tempCount << endl;
-				}
+				sched_yield();
+				position = logHead.load(memory_order_relaxed);
 			}
 			
-			//end process
 			else
 			{
-				if(logTo == 'M')
-				{
-					cout << fixed << tempStart << " - End process " << tempCount << endl;
-				}
-				
-				else if(logTo == 'F')
-				{
-					fout << fixed << tempStart << " - End process " << tempCount << endl;
-				}
-				
-				else
-				{
-					cout << fixed << tempStart << " - End process " << tempCount << endl;
-					fout << fixed << tempStart << " - End process " << tempCount << endl;
-				}
+				position = logHead.load(memory_order_relaxed);
 			}
 		}
 		
-		//processor
-		else
+		for(unsigned long i = 0; i < count; i++)
 		{
+			logSlot* tempSlot = &logRing[(position + i) & (LOGslots - 1)];
+			tempSlot->length = min(LOGslotSize, length - offset);
+			memcpy(tempSlot->text, text + offset, tempSlot->length);
+			offset += tempSlot->length;
+			tempSlot->sequence.store(position + i + 1, memory_order_release);
+		}
+	}
+}
+
+/**
+@brief  background thread that moves lines from the ring to the monitor and/or file
+@param  void *threadid
+@return  none
+@pre  startLogger()
+@post  flushes after every line of text, after every drained batch or only at exit depending on logFlush
+**/
+void* logFlusher(void *threadid)
+{
+	string batch;
+	
+	while(true)
+	{
+		bool running = logRunning.load(memory_order_acquire);
 		
-			if(logTo == 'M')
-			{
-				cout << fixed << tempStart << " - Process " << tempCount << ": start processing action" << endl;
-				cout << fixed << tempEnd << " - Process " << tempCount << ": end processing action" << endl;
-			}
-		
-			else if(logTo == 'F')
+		//take everything that is ready
+		while(true)
+		{
+			logSlot* tempSlot = &logRing[logTail & (LOGslots - 1)];
+			
+			if(tempSlot->sequence.load(memory_order_acquire) != logTail + 1)
 			{
-				fout << fixed << tempStart << " - Process " << tempCount << ": start processing action" << endl;
-				fout << fixed << tempEnd << " - Process " << tempCount << ": end processing action" << endl;
+				break;
 			}
 			
-			else
+			batch.append(tempSlot->text, tempSlot->length);
+			tempSlot->sequence.store(logTail + LOGslots, memory_order_release);
+			logTail++;
+			
+			//a slot can hold several lines or part of one, flush at each end of line
+			size_t lineEnd;
+			
+			while(logFlush == FLUSHline && (lineEnd = batch.find('\n')) != string::npos)
 			{
-				cout << fixed << tempStart << " - Process " << tempCount << ": start processing action" << endl;
-				cout << fixed << tempEnd << " - Process " << tempCount << ": end processing action" << endl;
-				fout << fixed << tempStart << " - Process " << tempCount << ": start processing action" << endl;
-				fout << fixed << tempEnd << " - Process " << tempCount << ": end processing action" << endl;
+				string line = batch.substr(0, lineEnd + 1);
+				logEmit(line, true);
+				batch.erase(0, lineEnd + 1);
 			}
 		}
+		
+		//in line mode a partial line waits for the rest of it
+		if(!batch.empty() && logFlush != FLUSHline)
+		{
+			logEmit(batch, logFlush == FLUSHbatch);
+			batch.clear();
+		}
+		
+		//the ring was drained after the stop request, nothing more can come in
+		if(!running)
+		{
+			break;
+		}
+		
+		timespec tempWait;
+		tempWait.tv_sec = 0;
+		tempWait.tv_nsec = 1000000;
+		nanosleep(&tempWait, NULL);
 	}
 	
-	//if process was interrupted by PQN
-	if(isReset == true)
+	logEmit(batch, true);
+	pthread_exit(0);
+}
+
+/**
+@brief  writes text to the monitor and/or the log file
+@param  string &text, bool flush
+@return  none
+@pre  startLogger()
+@post  the streams are flushed if asked to
+**/
+void logEmit(string& text, bool flush)
+{
+	if(logTo != 'F')
 	{
-		if(logTo == 'M')
+		cout.write(text.data(), text.size());
+		
+		if(flush)
 		{
-			cout << fixed << currentClock << " - ******* Process was interrupted *******" << endl;
+			cout.flush();
 		}
+	}
 	
-		else if(logTo == 'F')
-		{
-			fout << fixed << currentClock << " - ******* Process was interrupted *******" << endl;
-		}
+	if(logTo != 'M')
+	{
+		logFile.write(text.data(), text.size());
 		
-		else
+		if(flush)
 		{
-			cout << fixed << currentClock << " - ******* Process was interrupted *******" << endl;
-			fout << fixed << currentClock << " - ******* Process was interrupted *******" << endl;
+			logFile.flush();
 		}
 	}
-	
-	//close file
-	fout.close();
 }
+
 //----------------------------------------------------------------------------------------------------
-//resource management system
+//trace export
 //----------------------------------------------------------------------------------------------------
 
 /**
-@brief  a function that checks if the process is an input/output and calls the appropriate function
-@param  none
-@return  none  
-@pre  ioProcess(), nonIOProcess()
-@post  sets the PCB and runs the thread according
+@brief  opens the trace file and names one track for every processor and device, does nothing without a trace file
+@param  string filename
+@return  none
+@pre  startDevicePool()
+@post  traceOperation() and setState() stream records until stopTrace()
 **/
-void timerProcess(processData tempProcess)
-{	
-	//create thread, variable declarations and start process control block
-	pthread_t thread2;
-	pthread_t thread3;
-	tempPCB.processState = PCBstart;
-	quantumTime = tempConfig.pqn;
-	int checkTime;
-	int tempCount;
-	string tempCode;
-	string tempCommand;
-	
-	while(!tempProcess.commands.empty())
-	{	
-		//copy process information
-		tempPCB.processState = PCBrunning;
-		totalTime = tempProcess.commands.front().cycleTime;
-		tempCode = tempProcess.commands.front().opCode;
-		tempCommand = tempProcess.commands.front().opCommand;
-		tempCount = tempProcess.processCount;
-		checkTime += totalTime;
-		
-		//100ms check
-		if(checkTime > 100)
-		{
-			//second thread for adding to STR or RR queue
-			//pthread_create(&thread2, NULL, &loadThread, NULL);
-			//pthread_join(thread2, NULL);
-			loadProcess();
-			checkTime = 0;
-		}
-		
-		//round robin scheduling
-		if(rrs == true)
-		{
-			pthread_create(&thread3, NULL, &rrThread, NULL);
-			pthread_join(thread3, NULL);
-			
-			if(totalTime > quantumTime)
-			{
-				tempProcess.commands.front().cycleTime -= quantumTime;
-				totalTime = quantumTime;
-				rrQueue.push(tempProcess);
-				isReset = true;
-				simulateProcess(tempCode);
-				output(tempConfig.logFile, tempCode, tempCommand, tempCount, startTime, endTime);
-				break;
-			}
-		
-			else if(totalTime < quantumTime)
-			{
-				quantumTime = quantumTime - totalTime;
-				isReset = false;
-			
-				if(quantumTime < 0)
-				{
-					quantumTime = 0;
-				}
-			}
+void startTrace(string filename)
+{
+	if(filename.empty())
+	{
+		return;
+	}
+	
+	traceFile.open(filename.c_str());
+	
+	if(!traceFile.is_open())
+	{
+		throw runtime_error("trace file could not be opened");
+	}
+	
+	traceBuffer = new traceRecord[TRACErecords];
+	traceSpare = new traceRecord[TRACErecords];
+	traceOut = new char[TRACEbuffer + LOGslotSize];
+	traceLength = 0;
+	traceFile << "{\"traceEvents\":[\n";
+	char event[LOGslotSize];
+	
+	traceEvent(event, snprintf(event, sizeof(event), "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"Processors and devices\"}}"));
+	traceEvent(event, snprintf(event, sizeof(event), "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":2,\"args\":{\"name\":\"Processes\"}}"));
+	
+	for(int i = 0; i < NUMdevices; i++)
+	{
+		for(unsigned int j = 0; j < devicePool[i].size(); j++)
+		{
+			traceEvent(event, snprintf(event, sizeof(event), "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s %u\"}}", i*TRACEunits + j, deviceNames[i], j));
 		}
-		
-		//run if earlier criteria not met
-		simulateProcess(tempCode);
-		output(tempConfig.logFile, tempCode, tempCommand, tempCount, startTime, endTime);
-		tempPCB.processState = PCBexit;
-		tempProcess.commands.pop();
 	}
 	
-	//exit process control block
-	tempPCB.processState = PCBexit;
+	traceOn = true;
+	traceRunning = true;
+	pthread_mutex_init(&traceMtx, NULL);
+	pthread_cond_init(&traceReady, NULL);
+	pthread_create(&traceThread, NULL, &traceWriter, NULL);
 }
 
 /**
-@brief  round robin thread
-@param  void *threadid
+@brief  writes the rest of the buffered records and closes the trace
+@param  none
 @return  none
-@pre  none
-@post  none
+@pre  startTrace()
+@post  the trace file is a complete JSON document
 **/
-void* rrThread(void *threadid)
-{	
-	pthread_exit(0);
+void stopTrace()
+{
+	if(!traceOn)
+	{
+		return;
+	}
+	
+	//let the writer finish the last full buffer
+	pthread_mutex_lock(&traceMtx);
+	traceRunning = false;
+	pthread_cond_broadcast(&traceReady);
+	pthread_mutex_unlock(&traceMtx);
+	pthread_join(traceThread, NULL);
+	pthread_mutex_destroy(&traceMtx);
+	pthread_cond_destroy(&traceReady);
+	
+	traceWrite(traceBuffer, traceLength);
+	traceFile << "\n]}\n";
+	traceFile.close();
+	delete[] traceBuffer;
+	delete[] traceSpare;
+	delete[] traceOut;
+	traceBuffer = NULL;
+	traceSpare = NULL;
+	traceOut = NULL;
+	traceOn = false;
 }
 
 /**
-@brief  function that simulates the process task
-@param  string opCode
+@brief  background thread that formats and writes each full record buffer, so JSON and file writes stay off the scheduler
+@param  void *unused
 @return  none
-@pre  ioProcess(), nonIOProcess()
-@post  outputs start and end time for a process task
+@pre  startTrace()
+@post  every buffer handed over has been written and given back as the spare
 **/
-void simulateProcess(string opCode)
+void* traceWriter(void*)
 {
-	//declare thread
-	pthread_t thread1;
+	pthread_mutex_lock(&traceMtx);
 	
-	//if input/output, run thread using ioProcess()
-	if(opCode == "input" || opCode == "output")
+	while(true)
 	{
-		pthread_create(&thread1, NULL, &ioProcess, NULL);
-		pthread_join(thread1, NULL);
-		tempPCB.processState = PCBwaiting;
-		tempPCB.processState = PCBexit;
+		while(traceFull == NULL && traceRunning)
+		{
+			pthread_cond_wait(&traceReady, &traceMtx);
+		}
+		
+		if(traceFull == NULL)
+		{
+			break;
+		}
+		
+		traceRecord* tempBuffer = traceFull;
+		unsigned int length = traceFullLength;
+		pthread_mutex_unlock(&traceMtx);
+		
+		traceWrite(tempBuffer, length);
+		
+		pthread_mutex_lock(&traceMtx);
+		traceSpare = tempBuffer;
+		traceFull = NULL;
+		pthread_cond_broadcast(&traceReady);
 	}
+	
+	pthread_mutex_unlock(&traceMtx);
+	pthread_exit(0);
+}
 
-	//else, call nonIOProcess()
-	else
+/**
+@brief  writes one preformatted event straight to the trace file
+@param  const char *text, int length
+@return  none
+@pre  startTrace(), before the writer thread starts
+@post  events after the first are separated by a comma
+**/
+void traceEvent(const char* text, int length)
+{
+	if(!traceFirst)
 	{
-		nonIOProcess();
+		traceFile << ",\n";
 	}
+	
+	traceFirst = false;
+	traceFile.write(text, length);
 }
 
 /**
-@brief  a function that adds processes to the end of STR or RR queue
-@param  none
+@brief  formats records as JSON events and writes them a block at a time
+@param  traceRecord *records, unsigned int count
 @return  none
-@pre  none
-@post  every 100 ms, a duplicate of the earlier processes will be added, up to 10 times
+@pre  the writer thread, or stopTrace() once it has stopped
+@post  events after the first are separated by a comma
 **/
-void loadProcess()
+void traceWrite(traceRecord* records, unsigned int count)
 {
-	if (totalCount < 9)
+	char* out = traceOut;
+	
+	for(unsigned int i = 0; i < count; i++)
 	{
-		//delay(100);
-		queue<processData> tempQueue;
-		tempQueue = masterQueue;
-		
-		while(!tempQueue.empty())
-		{	
-			tempQueue.front().processCount = ++processID;
-			
-			if(strs == true)
-			{
-				strQueue.push(tempQueue.front());
-			}
-			
-			else
-			{
-				rrQueue.push(tempQueue.front());
-			}
-			
-			tempQueue.pop();
+		if(!traceFirst)
+		{
+			*out++ = ',';
+			*out++ = '\n';
 		}
 		
-		totalCount++;
+		traceFirst = false;
+		out = traceFormat(out, records[i]);
+		
+		if(out - traceOut >= (long)TRACEbuffer)
+		{
+			traceFile.write(traceOut, out - traceOut);
+			out = traceOut;
+		}
 	}
+	
+	traceFile.write(traceOut, out - traceOut);
 }
 
 /**
-@brief  a function that adds processes to the end of STR or RR queue
-@param  void *threadid
-@return  none
-@pre  delay()
-@post  every 100 ms, a duplicate of the earlier processes will be added, up to 10 times
+@brief  formats one record as a JSON event
+@param  char *out, const traceRecord &record
+@return  char* the end of the event, at most LOGslotSize characters on
+@pre  traceWrite()
+@post  none
 **/
-void* loadThread(void *threadid)
+char* traceFormat(char* out, const traceRecord& record)
 {
-	//mutex lock
-	pthread_mutex_lock(&mtx2);
+	//name the process track the first time it shows up
+	if(record.type == TRACEname)
+	{
+		return out + snprintf(out, LOGslotSize, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":2,\"tid\":%d,\"args\":{\"name\":\"Process %d\"}}", record.track, record.process);
+	}
 	
-	if (totalCount < 9)
+	if(record.type == TRACEspan)
 	{
-		//delay(100);
-		queue<processData> tempQueue;
-		tempQueue = masterQueue;
+		const opDescriptor& tempOp = opTable[record.op];
+		out = traceText(out, "{\"name\":\"");
+		*out++ = tempOp.code;
+		*out++ = '{';
+		out = traceText(out, tempOp.descriptor);
+		out = traceText(out, "}\",\"ph\":\"X\",\"pid\":1,\"tid\":");
+	}
+	
+	else if(record.type == TRACEready)
+	{
+		out = traceText(out, "{\"name\":\"ready\",\"ph\":\"X\",\"pid\":2,\"tid\":");
+	}
+	
+	else
+	{
+		out = traceText(out, "{\"name\":\"exit\",\"ph\":\"i\",\"s\":\"t\",\"pid\":2,\"tid\":");
+	}
+	
+	out = traceNumber(out, record.track);
+	out = traceText(out, ",\"ts\":");
+	out = traceNumber(out, record.start);
+	
+	if(record.type != TRACEexit)
+	{
+		out = traceText(out, ",\"dur\":");
+		out = traceNumber(out, record.length);
+	}
+	
+	if(record.type == TRACEspan)
+	{
+		out = traceText(out, ",\"args\":{\"process\":");
+		out = traceNumber(out, record.process);
+		*out++ = '}';
+	}
+	
+	*out++ = '}';
+	return out;
+}
+
+/**
+@brief  makes room for one record at the end of the trace buffer, swapping buffers with the writer when it is full
+@param  none
+@return  traceRecord* where the record goes
+@pre  startTrace()
+@post  the record is counted, the caller fills it in
+**/
+traceRecord* traceReserve()
+{
+	//hand the full buffer to the writer and carry on in the spare
+	if(traceLength == TRACErecords)
+	{
+		pthread_mutex_lock(&traceMtx);
 		
-		while(!tempQueue.empty())
-		{	
-			tempQueue.front().processCount = ++processID;
-			
-			if(strs == true)
-			{
-				strQueue.push(tempQueue.front());
-			}
-			
-			else
-			{
-				rrQueue.push(tempQueue.front());
-			}
-			
-			tempQueue.pop();
+		while(traceFull != NULL)
+		{
+			pthread_cond_wait(&traceReady, &traceMtx);
 		}
 		
-		totalCount++;
+		traceFull = traceBuffer;
+		traceFullLength = traceLength;
+		traceBuffer = traceSpare;
+		traceSpare = NULL;
+		pthread_cond_broadcast(&traceReady);
+		pthread_mutex_unlock(&traceMtx);
+		traceLength = 0;
 	}
 	
-	//mutex unlock and exit the thread
-  	pthread_mutex_unlock(&mtx2);
-	pthread_exit(0);
+	return traceBuffer + traceLength++;
 }
 
-
 /**
-@brief  a function that is similar to nonIOProcess() but is for an input/output cycle that uses a thread
-@param  void *threadid
-@return  none
-@pre  delay()
-@post  takes the global tempInput.processValue and puts the cycle time into tempTimer.StartValue and tempTimer.EndValue
+@brief  copies text into an event
+@param  char *out, const char *text
+@return  char* the end of the copy
+@pre  traceReserve()
+@post  none
 **/
-void* ioProcess(void *threadid)
+char* traceText(char* out, const char* text)
 {
-	//mutex lock
-	pthread_mutex_lock(&mtx);
-	
-	//process time start
-	startTime = (clock()-timerStart)/(double)(CLOCKS_PER_SEC);
-	
-	//simulate delay
- 	delay(totalTime);
-	
-	//process time end
-	endTime = (clock()-timerStart)/(double)(CLOCKS_PER_SEC);	
-  	
-  	//mutex unlock and exit the thread
-  	pthread_mutex_unlock(&mtx);	
-  	pthread_exit(0);
+	size_t length = strlen(text);
+	memcpy(out, text, length);
+	return out + length;
 }
 
 /**
-@brief a function that simulates a cycle time for a given process, not for input/output
-@param  none
-@return  none
-@pre  delay()
-@post  takes the global tempInput.processValue and puts the cycle time into tempTimer.StartValue and tempTimer.EndValue
+@brief  writes a whole number into an event, much cheaper than snprintf for the writer
+@param  char *out, long value
+@return  char* the end of the number
+@pre  traceReserve()
+@post  none
 **/
-void nonIOProcess()
-{	
-	//process time start
-	startTime = (clock()-timerStart)/(double)(CLOCKS_PER_SEC);
+char* traceNumber(char* out, long value)
+{
+	static const char pairs[] =
+		"00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+		"40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+		"8081828384858687888990919293949596979899";
+	char digits[24];
+	int count = sizeof(digits);
+	
+	if(value < 0)
+	{
+		*out++ = '-';
+		value = -value;
+	}
+	
+	//two digits per division
+	while(value >= 100)
+	{
+		int pair = (value % 100)*2;
+		value /= 100;
+		digits[--count] = pairs[pair + 1];
+		digits[--count] = pairs[pair];
+	}
 	
-	//simulate delay
- 	delay(totalTime);
+	if(value >= 10)
+	{
+		digits[--count] = pairs[value*2 + 1];
+		digits[--count] = pairs[value*2];
+	}
+	
+	else
+	{
+		digits[--count] = '0' + value;
+	}
 	
-	//process time end
-	endTime = (clock()-timerStart)/(double)(CLOCKS_PER_SEC);	
+	memcpy(out, digits + count, sizeof(digits) - count);
+	return out + sizeof(digits) - count;
 }
 
 /**
-@brief  a function that simulates a delay based on the process time
-@param  int milliseconds
+@brief  records a finished job as a span on its processor or device track, times in whole microseconds
+@param  ioJob *tempJob
 @return  none
-@pre  none
+@pre  completeIO()
 @post  none
 **/
-void delay(int milliseconds)
+void traceOperation(ioJob* tempJob)
 {
-	long duration = milliseconds * (CLOCKS_PER_SEC/1000);
-	clock_t alpha, omega;
-	
-	omega = alpha = clock();
-	while ( (omega - alpha) < duration)
+	if(!traceOn)
 	{
-			omega = clock();
+		return;
 	}
+	
+	traceRecord* record = traceReserve();
+	record->type = TRACEspan;
+	record->op = tempJob->op;
+	record->track = tempJob->device*TRACEunits + tempJob->unit;
+	record->process = tempJob->processCount;
+	record->start = (long)(tempJob->startTime*1000000.0 + 0.5);
+	record->length = (long)(tempJob->endTime*1000000.0 + 0.5) - record->start;
 }
 
 /**
-@brief  runs an output print for the start of a simulation
-@param  string filename
+@brief  moves a process to a new state, timing its scheduling metrics and tracing its time on a ready queue on the process's own track
+@param  int id, int state
 @return  none
-@pre  none
-@post  prints the start time for a program simulation
+@pre  newProcess()
+@post  tempPCB holds the new state
 **/
-void startOutput(string filename)
+void setState(int id, int state)
 {
-	ofstream fout;
-	fout.open(filename.c_str(),ios::app);
+	processData& tempProcess = processTable[id];
+	double now = currentTime();
+	double readied = tempProcess.readySince;
+	tempPCB.processState = state;
+	tempProcess.state = state;
 	
-	double currentClock = (clock()-clockStart)/(double)(CLOCKS_PER_SEC);
-			
-	if(logTo == 'M')
+	//scheduling metrics
+	if(state == PCBready)
 	{
-		cout << fixed << currentClock << " - Simulator program starting" << endl;
+		if(tempProcess.arrival < 0.0)
+		{
+			tempProcess.arrival = now;
+		}
+		
+		tempProcess.readySince = now;
 	}
 	
-	else if(logTo == 'F')
+	else if(state == PCBstart)
 	{
-		fout << fixed << currentClock << " - Simulator program starting" << endl;
+		if(tempProcess.readySince >= 0.0)
+		{
+			tempProcess.waiting += now - tempProcess.readySince;
+			tempProcess.readySince = -1.0;
+		}
+		
+		if(tempProcess.firstRun < 0.0)
+		{
+			tempProcess.firstRun = now;
+		}
 	}
 	
-	else
+	else if(state == PCBexit)
+	{
+		tempProcess.finish = now;
+	}
+	
+	//one ready span per dispatch and the exit, the processor and device spans already show it running and waiting
+	if(!traceOn || (state != PCBstart && state != PCBexit) || (state == PCBstart && readied < 0.0))
+	{
+		return;
+	}
+	
+	//name the process track the first time it shows up
+	if(!tempProcess.traced)
 	{
-		cout << fixed << currentClock << " - Simulator program starting" << endl;
-		fout << fixed << currentClock << " - Simulator program starting" << endl;
+		traceRecord* record = traceReserve();
+		record->type = TRACEname;
+		record->track = id;
+		record->process = tempProcess.processCount;
+		tempProcess.traced = true;
 	}
 	
-	fout.close();	
+	traceRecord* record = traceReserve();
+	record->type = (state == PCBstart) ? TRACEready : TRACEexit;
+	record->track = id;
+	record->process = tempProcess.processCount;
+	record->start = (long)(((state == PCBstart) ? readied : now)*1000000.0 + 0.5);
+	record->length = (long)(now*1000000.0 + 0.5) - record->start;
 }
 
 /**
-@brief  runs an output print for the end of a simulation
-@param  string filename
-@return  none
+@brief  shortest time remaining ordering, ties go to the older process
+@param  int a, int b
+@return  bool
 @pre  none
-@post  prints the end time for a program simulation
+@post  none
 **/
-void endOutput(string filename)
+bool strLess(int a, int b)
+{
+	int timeA = timeRemaining(processTable[a]);
+	int timeB = timeRemaining(processTable[b]);
+	
+	if(timeA != timeB)
+	{
+		return (timeA < timeB);
+	}
+	
+	return (a < b);
+}
+
+/**
+@brief  adds a ready process to a processor's STR heap
+@param  int core, int id
+@return  none
+@pre  newProcess()
+@post  O(log n)
+**/
+void strPush(int core, int id)
 {
-	ofstream fout;
-	fout.open(filename.c_str(),ios::app);
+	vector<int>& strHeap = cores[core].strHeap;
+	strHeap.push_back(id);
+	strSiftUp(core, strHeap.size() - 1);
+}
 
-	double clockEnd = (clock()-clockStart)/(double)(CLOCKS_PER_SEC);
-			
-	if(logTo == 'M')
+/**
+@brief  removes the ready process with the shortest time remaining from a processor's STR heap
+@param  int core
+@return  int id
+@pre  the heap is not empty
+@post  O(log n)
+**/
+int strPop(int core)
+{
+	vector<int>& strHeap = cores[core].strHeap;
+	int id = strHeap[0];
+	strHeap[0] = strHeap.back();
+	strHeap.pop_back();
+	
+	if(!strHeap.empty())
 	{
-		cout << fixed << clockEnd << " - Simulator program ending" << endl;
+		strSiftDown(core, 0);
 	}
 	
-	else if(logTo == 'F')
+	return id;
+}
+
+/**
+@brief  moves a heap entry up past larger parents
+@param  int core, int position
+@return  none
+@pre  none
+@post  O(log n)
+**/
+void strSiftUp(int core, int position)
+{
+	vector<int>& strHeap = cores[core].strHeap;
+	int id = strHeap[position];
+	
+	while(position > 0)
 	{
-		fout << fixed << clockEnd << " - Simulator program ending" << endl;
+		int parent = (position - 1)/2;
+		
+		if(!strLess(id, strHeap[parent]))
+		{
+			break;
+		}
+		
+		strHeap[position] = strHeap[parent];
+		position = parent;
 	}
 	
-	else
+	strHeap[position] = id;
+}
+
+/**
+@brief  moves a heap entry down past smaller children
+@param  int core, int position
+@return  none
+@pre  none
+@post  O(log n)
+**/
+void strSiftDown(int core, int position)
+{
+	vector<int>& strHeap = cores[core].strHeap;
+	int id = strHeap[position];
+	int size = strHeap.size();
+	
+	while(true)
 	{
-		cout << fixed << clockEnd << " - Simulator program ending" << endl;
-		fout << fixed << clockEnd << " - Simulator program ending" << endl;
+		int child = (position*2) + 1;
+		
+		if(child >= size)
+		{
+			break;
+		}
+		
+		if(child + 1 < size && strLess(strHeap[child + 1], strHeap[child]))
+		{
+			child++;
+		}
+		
+		if(!strLess(strHeap[child], id))
+		{
+			break;
+		}
+		
+		strHeap[position] = strHeap[child];
+		position = child;
 	}
 	
-	fout.close();	
+	strHeap[position] = id;
 }
 
 /**
@@ -1433,20 +5474,25 @@ void endOutput(string filename)
 @post  none
 **/
 
-bool operator>(processData x, processData y)
+bool operator>(const processData& x, const processData& y)
 {
-	return (x.countIO < y.countIO);
+	return (x.program->countIO < y.program->countIO);
 }
 
 /**
-@brief  shortest job first scheduling comparative operator
-@param  processData a, processData b
-@return  none
+@brief  event queue comparative operator, earliest time first
+@param  simEvent a, simEvent b
+@return  bool
 @pre  none
 @post  none
 **/
 
-bool operator<(processData x, processData y)
+bool operator>(simEvent x, simEvent y)
 {
-	return (x.countTask > y.countTask);
+	if(x.time != y.time)
+	{
+		return (x.time > y.time);
+	}
+	
+	return (x.sequence > y.sequence);
 }